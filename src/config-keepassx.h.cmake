@@ -13,4 +13,7 @@
 #cmakedefine HAVE_RLIMIT_CORE 1
 #cmakedefine HAVE_PT_DENY_ATTACH 1
 
+#cmakedefine HAVE_AESNI 1
+#cmakedefine HAVE_SSE2 1
+
 #endif // KEEPASSX_CONFIG_H
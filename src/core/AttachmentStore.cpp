@@ -0,0 +1,128 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AttachmentStore.h"
+
+#include <QtCore/QMutexLocker>
+
+#include "crypto/CryptoHash.h"
+
+Q_GLOBAL_STATIC(AttachmentStore, s_attachmentStore)
+
+AttachmentStore::AttachmentStore()
+{
+}
+
+QByteArray AttachmentStore::add(const QByteArray& data)
+{
+    QByteArray hash = CryptoHash::hash(data, CryptoHash::Sha256);
+
+    QMutexLocker locker(&m_mutex);
+    insert(hash, data);
+
+    return hash;
+}
+
+/**
+ * Adds several attachments at once, the hashes are computed as a batch.
+ */
+QList<QByteArray> AttachmentStore::add(const QList<QByteArray>& data)
+{
+    QList<QByteArray> hashes = CryptoHash::hashes(data, CryptoHash::Sha256);
+
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < data.size(); i++) {
+        insert(hashes[i], data[i]);
+    }
+
+    return hashes;
+}
+
+void AttachmentStore::insert(const QByteArray& hash, const QByteArray& data)
+{
+    QHash<QByteArray, Blob>::iterator it = m_blobs.find(hash);
+    if (it == m_blobs.end()) {
+        Blob blob;
+        blob.data = data;
+        blob.refCount = 1;
+        m_blobs.insert(hash, blob);
+    }
+    else {
+        it.value().refCount++;
+    }
+}
+
+void AttachmentStore::ref(const QByteArray& hash)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QHash<QByteArray, Blob>::iterator it = m_blobs.find(hash);
+    Q_ASSERT(it != m_blobs.end());
+    if (it != m_blobs.end()) {
+        it.value().refCount++;
+    }
+}
+
+void AttachmentStore::release(const QByteArray& hash)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QHash<QByteArray, Blob>::iterator it = m_blobs.find(hash);
+    Q_ASSERT(it != m_blobs.end());
+    if (it != m_blobs.end()) {
+        it.value().refCount--;
+        if (it.value().refCount == 0) {
+            m_blobs.erase(it);
+        }
+    }
+}
+
+QByteArray AttachmentStore::data(const QByteArray& hash) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QHash<QByteArray, Blob>::const_iterator it = m_blobs.constFind(hash);
+    if (it == m_blobs.constEnd()) {
+        return QByteArray();
+    }
+
+    return it.value().data;
+}
+
+int AttachmentStore::size(const QByteArray& hash) const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QHash<QByteArray, Blob>::const_iterator it = m_blobs.constFind(hash);
+    if (it == m_blobs.constEnd()) {
+        return 0;
+    }
+
+    return it.value().data.size();
+}
+
+int AttachmentStore::count() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_blobs.size();
+}
+
+AttachmentStore* AttachmentStore::instance()
+{
+    return s_attachmentStore();
+}
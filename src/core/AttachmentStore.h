@@ -0,0 +1,70 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_ATTACHMENTSTORE_H
+#define KEEPASSX_ATTACHMENTSTORE_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+
+#include "core/Global.h"
+
+/**
+ * Content-addressed store for attachment data.
+ *
+ * Every distinct attachment is kept once, keyed by its SHA-256 hash,
+ * and reference counted by the EntryAttachments objects using it.
+ * The store is shared by all databases since history items and
+ * attachments edited in the GUI don't belong to a database.
+ */
+class AttachmentStore
+{
+public:
+    AttachmentStore();
+
+    QByteArray add(const QByteArray& data);
+    QList<QByteArray> add(const QList<QByteArray>& data);
+    void ref(const QByteArray& hash);
+    void release(const QByteArray& hash);
+    QByteArray data(const QByteArray& hash) const;
+    int size(const QByteArray& hash) const;
+    int count() const;
+
+    static AttachmentStore* instance();
+
+private:
+    void insert(const QByteArray& hash, const QByteArray& data);
+
+    struct Blob
+    {
+        QByteArray data;
+        int refCount;
+    };
+
+    mutable QMutex m_mutex;
+    QHash<QByteArray, Blob> m_blobs;
+
+    Q_DISABLE_COPY(AttachmentStore)
+};
+
+inline AttachmentStore* attachmentStore() {
+    return AttachmentStore::instance();
+}
+
+#endif // KEEPASSX_ATTACHMENTSTORE_H
@@ -17,25 +17,33 @@
 
 #include "Database.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QFile>
+#include <QtCore/QMutexLocker>
 #include <QtCore/QTimer>
 #include <QtCore/QXmlStreamReader>
 
 #include "core/Group.h"
 #include "core/Metadata.h"
+#include "core/ProgressMonitor.h"
+#include "core/SearchIndex.h"
 #include "core/Tools.h"
 #include "crypto/Random.h"
 #include "format/KeePass2.h"
 
 QHash<Uuid, Database*> Database::m_uuidMap;
+// databases may be created by readers running in other threads
+QMutex Database::m_uuidMapMutex;
 
 Database::Database()
     : m_metadata(new Metadata(this))
+    , m_searchIndex(new SearchIndex(this))
     , m_timer(new QTimer(this))
     , m_cipher(KeePass2::CIPHER_AES)
     , m_compressionAlgo(CompressionGZip)
     , m_transformRounds(50000)
     , m_hasKey(false)
+    , m_pendingTransformMonitor(Q_NULLPTR)
     , m_emitModified(false)
     , m_uuid(Uuid::random())
 {
@@ -43,7 +51,9 @@ Database::Database()
     rootGroup()->setUuid(Uuid::random());
     m_timer->setSingleShot(true);
 
+    m_uuidMapMutex.lock();
     m_uuidMap.insert(m_uuid, this);
+    m_uuidMapMutex.unlock();
 
     connect(m_metadata, SIGNAL(modified()), this, SIGNAL(modifiedImmediate()));
     connect(m_metadata, SIGNAL(nameTextChanged()), this, SIGNAL(nameTextChanged()));
@@ -53,7 +63,17 @@ Database::Database()
 
 Database::~Database()
 {
+    cancelKeyTransform();
+
+    // Delete the groups while the indexes still exist, groups and entries
+    // remove themselves from them on deletion. The signals of the database
+    // are still connected, so models that show its entries are notified.
+    setEmitModified(false);
+    delete m_rootGroup;
+
+    m_uuidMapMutex.lock();
     m_uuidMap.remove(m_uuid);
+    m_uuidMapMutex.unlock();
 }
 
 Group* Database::rootGroup()
@@ -86,46 +106,44 @@ const Metadata* Database::metadata() const
 
 Entry* Database::resolveEntry(const Uuid& uuid)
 {
-    return recFindEntry(uuid, m_rootGroup);
+    return m_entryIndex.value(uuid);
 }
 
-Entry* Database::recFindEntry(const Uuid& uuid, Group* group)
+Group* Database::resolveGroup(const Uuid& uuid)
 {
-    Q_FOREACH (Entry* entry, group->entries()) {
-        if (entry->uuid() == uuid) {
-            return entry;
-        }
-    }
+    return m_groupIndex.value(uuid);
+}
 
-    Q_FOREACH (Group* child, group->children()) {
-        Entry* result = recFindEntry(uuid, child);
-        if (result) {
-            return result;
-        }
+void Database::indexEntry(Entry* entry)
+{
+    if (!entry->uuid().isNull()) {
+        m_entryIndex.insert(entry->uuid(), entry);
     }
 
-    return Q_NULLPTR;
+    m_searchIndex->addEntry(entry);
 }
 
-Group* Database::resolveGroup(const Uuid& uuid)
+void Database::unindexEntry(Entry* entry)
 {
-    return recFindGroup(uuid, m_rootGroup);
+    if (m_entryIndex.value(entry->uuid()) == entry) {
+        m_entryIndex.remove(entry->uuid());
+    }
+
+    m_searchIndex->removeEntry(entry);
 }
 
-Group* Database::recFindGroup(const Uuid& uuid, Group* group)
+void Database::indexGroup(Group* group)
 {
-    if (group->uuid() == uuid) {
-        return group;
+    if (!group->uuid().isNull()) {
+        m_groupIndex.insert(group->uuid(), group);
     }
+}
 
-    Q_FOREACH (Group* child, group->children()) {
-        Group* result = recFindGroup(uuid, child);
-        if (result) {
-            return result;
-        }
+void Database::unindexGroup(Group* group)
+{
+    if (m_groupIndex.value(group->uuid()) == group) {
+        m_groupIndex.remove(group->uuid());
     }
-
-    return Q_NULLPTR;
 }
 
 QList<DeletedObject> Database::deletedObjects()
@@ -170,7 +188,12 @@ quint64 Database::transformRounds() const
 
 QByteArray Database::transformedMasterKey() const
 {
-    return m_transformedMasterKey;
+    if (m_pendingTransformMonitor) {
+        return m_pendingTransform.result();
+    }
+    else {
+        return m_transformedMasterKey;
+    }
 }
 
 void Database::setCipher(const Uuid& cipher)
@@ -193,26 +216,59 @@ void Database::setTransformRounds(quint64 rounds)
         m_transformRounds = rounds;
 
         if (m_hasKey) {
-            setKey(m_key);
+            startKeyTransform(Random::randomArray(32));
+            m_metadata->setMasterKeyChanged(Tools::currentDateTimeUtc());
+            Q_EMIT modifiedImmediate();
         }
     }
 }
 
-void Database::setKey(const CompositeKey& key, const QByteArray& transformSeed, bool updateChangedTime)
+bool Database::setKey(const CompositeKey& key, const QByteArray& transformSeed, bool updateChangedTime,
+                      ProgressMonitor* monitor)
 {
+    QByteArray rawKey = key.rawKey();
+    QByteArray transformedMasterKey;
+
+    // m_transformSeed and m_transformRounds always belong to the current or pending transformation
+    if (m_hasKey && rawKey == m_rawKey && transformSeed == m_transformSeed) {
+        finishKeyTransform();
+        transformedMasterKey = m_transformedMasterKey;
+    }
+    else {
+        bool hadPendingTransform = (m_pendingTransformMonitor != Q_NULLPTR);
+        QByteArray pendingTransformSeed = m_transformSeed;
+        cancelKeyTransform();
+
+        transformedMasterKey = key.transform(transformSeed, transformRounds(), monitor);
+        if (transformedMasterKey.isEmpty()) {
+            if (hadPendingTransform) {
+                startKeyTransform(pendingTransformSeed);
+            }
+            return false;
+        }
+    }
+
     m_key = key;
+    m_rawKey = rawKey;
     m_transformSeed = transformSeed;
-    m_transformedMasterKey = key.transform(transformSeed, transformRounds());
+    m_transformedMasterKey = transformedMasterKey;
     m_hasKey = true;
     if (updateChangedTime) {
         m_metadata->setMasterKeyChanged(Tools::currentDateTimeUtc());
     }
     Q_EMIT modifiedImmediate();
+
+    return true;
 }
 
 void Database::setKey(const CompositeKey& key)
 {
-    setKey(key, Random::randomArray(32));
+    if (m_hasKey && key.rawKey() == m_rawKey) {
+        setKey(key, m_transformSeed);
+    }
+    else {
+        setKey(key, Random::randomArray(32));
+    }
 }
 
 bool Database::hasKey() const
@@ -224,7 +280,43 @@ bool Database::verifyKey(const CompositeKey& key) const
 {
     Q_ASSERT(hasKey());
 
-    return (m_key.rawKey() == key.rawKey());
+    return (m_rawKey == key.rawKey());
+}
+
+void Database::startKeyTransform(const QByteArray& transformSeed)
+{
+    Q_ASSERT(m_hasKey);
+
+    cancelKeyTransform();
+
+    m_transformSeed = transformSeed;
+    m_pendingTransformMonitor = new ProgressMonitor();
+    m_pendingTransform = QtConcurrent::run(m_key, &CompositeKey::transform, transformSeed, m_transformRounds,
+                                           m_pendingTransformMonitor);
+}
+
+void Database::finishKeyTransform()
+{
+    if (m_pendingTransformMonitor) {
+        m_transformedMasterKey = m_pendingTransform.result();
+
+        delete m_pendingTransformMonitor;
+        m_pendingTransformMonitor = Q_NULLPTR;
+    }
+}
+
+/**
+ * The caller has to replace the transformed key as it doesn't match the seed anymore.
+ */
+void Database::cancelKeyTransform()
+{
+    if (m_pendingTransformMonitor) {
+        m_pendingTransformMonitor->cancel();
+        m_pendingTransform.waitForFinished();
+
+        delete m_pendingTransformMonitor;
+        m_pendingTransformMonitor = Q_NULLPTR;
+    }
 }
 
 void Database::createRecycleBin()
@@ -276,6 +368,8 @@ Uuid Database::uuid()
 
 Database* Database::databaseByUuid(const Uuid& uuid)
 {
+    QMutexLocker locker(&m_uuidMapMutex);
+
     return m_uuidMap.value(uuid, 0);
 }
 
@@ -19,7 +19,9 @@
 #define KEEPASSX_DATABASE_H
 
 #include <QtCore/QDateTime>
+#include <QtCore/QFuture>
 #include <QtCore/QHash>
+#include <QtCore/QMutex>
 
 #include "core/Uuid.h"
 #include "keys/CompositeKey.h"
@@ -27,7 +29,9 @@
 class Entry;
 class Group;
 class Metadata;
+class ProgressMonitor;
 class QTimer;
+class SearchIndex;
 
 struct DeletedObject
 {
@@ -79,11 +83,23 @@ public:
 
     void setCipher(const Uuid& cipher);
     void setCompressionAlgo(Database::CompressionAlgorithm algo);
+    /**
+     * Changes the transform rounds and derives the transformed key with a new seed
+     * in the background. transformedMasterKey() waits for it to finish.
+     */
     void setTransformRounds(quint64 rounds);
-    void setKey(const CompositeKey& key, const QByteArray& transformSeed, bool updateChangedTime = true);
+
+    /**
+     * Returns false if the key transformation has been canceled through the monitor.
+     * The database key is left unchanged in that case.
+     * The key is not transformed again if it, the seed and the rounds didn't change.
+     */
+    bool setKey(const CompositeKey& key, const QByteArray& transformSeed, bool updateChangedTime = true,
+                ProgressMonitor* monitor = Q_NULLPTR);
 
     /**
      * Sets the database key and generates a random transform seed.
+     * The current seed is kept if the key didn't change.
      */
     void setKey(const CompositeKey& key);
     bool hasKey() const;
@@ -107,6 +123,12 @@ Q_SIGNALS:
     void groupRemoved();
     void groupAboutToMove(Group* group, Group* toGroup, int index);
     void groupMoved();
+    // entry signals of all groups in the database
+    void entryAboutToAdd(Entry* entry);
+    void entryAdded(Entry* entry);
+    void entryAboutToRemove(Entry* entry);
+    void entryRemoved(Entry* entry);
+    void entryDataChanged(Entry* entry);
     void nameTextChanged();
     void modified();
     void modifiedImmediate();
@@ -115,14 +137,23 @@ private Q_SLOTS:
     void startModifiedTimer();
 
 private:
-    Entry* recFindEntry(const Uuid& uuid, Group* group);
-    Group* recFindGroup(const Uuid& uuid, Group* group);
+    void indexEntry(Entry* entry);
+    void unindexEntry(Entry* entry);
+    void indexGroup(Group* group);
+    void unindexGroup(Group* group);
 
     void createRecycleBin();
 
+    void startKeyTransform(const QByteArray& transformSeed);
+    void finishKeyTransform();
+    void cancelKeyTransform();
+
     Metadata* const m_metadata;
     Group* m_rootGroup;
     QList<DeletedObject> m_deletedObjects;
+    QHash<Uuid, Entry*> m_entryIndex;
+    QHash<Uuid, Group*> m_groupIndex;
+    SearchIndex* const m_searchIndex;
     QTimer* m_timer;
 
     Uuid m_cipher;
@@ -132,11 +163,20 @@ private:
     QByteArray m_transformedMasterKey;
 
     CompositeKey m_key;
+    // raw key that m_transformedMasterKey has been derived from
+    QByteArray m_rawKey;
     bool m_hasKey;
+    QFuture<QByteArray> m_pendingTransform;
+    ProgressMonitor* m_pendingTransformMonitor;
     bool m_emitModified;
 
     Uuid m_uuid;
     static QHash<Uuid, Database*> m_uuidMap;
+    static QMutex m_uuidMapMutex;
+
+    // keep the indexes up to date and search through m_searchIndex
+    friend class Entry;
+    friend class Group;
 };
 
 #endif // KEEPASSX_DATABASE_H
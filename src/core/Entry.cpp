@@ -17,6 +17,7 @@
 
 #include "Entry.h"
 
+#include "core/AttachmentStore.h"
 #include "core/Database.h"
 #include "core/DatabaseIcons.h"
 #include "core/Group.h"
@@ -229,7 +230,17 @@ const EntryAttachments* Entry::attachments() const
 void Entry::setUuid(const Uuid& uuid)
 {
     Q_ASSERT(!uuid.isNull());
+
+    Database* db = m_group ? m_group->database() : Q_NULLPTR;
+    if (db) {
+        db->unindexEntry(this);
+    }
+
     set(m_uuid, uuid);
+
+    if (db) {
+        db->indexEntry(this);
+    }
 }
 
 void Entry::setIcon(int iconNumber)
@@ -406,7 +417,7 @@ void Entry::truncateHistory()
     int histMaxSize = db->metadata()->historyMaxSize();
     if (histMaxSize > -1) {
         int size = 0;
-        QSet<QByteArray> foundAttachements = attachments()->values().toSet();
+        QSet<QByteArray> foundAttachements = attachments()->hashes().toSet();
 
         QMutableListIterator<Entry*> i(m_history);
         i.toBack();
@@ -417,9 +428,9 @@ void Entry::truncateHistory()
             if (size <= histMaxSize) {
                 size += historyItem->attributes()->attributesSize();
 
-                QSet<QByteArray> newAttachments = historyItem->attachments()->values().toSet() - foundAttachements;
-                Q_FOREACH (const QByteArray& attachment, newAttachments) {
-                    size += attachment.size();
+                QSet<QByteArray> newAttachments = historyItem->attachments()->hashes().toSet() - foundAttachements;
+                Q_FOREACH (const QByteArray& hash, newAttachments) {
+                    size += attachmentStore()->size(hash);
                 }
                 foundAttachements += newAttachments;
             }
@@ -556,6 +567,11 @@ const Database* Entry::database() const
 bool Entry::match(const QString& searchTerm, Qt::CaseSensitivity caseSensitivity)
 {
     QStringList wordList = searchTerm.split(QRegExp("\\s"), QString::SkipEmptyParts);
+    return match(wordList, caseSensitivity);
+}
+
+bool Entry::match(const QStringList& wordList, Qt::CaseSensitivity caseSensitivity)
+{
     Q_FOREACH (const QString& word, wordList) {
         if (!wordMatch(word, caseSensitivity)) {
             return false;
@@ -127,6 +127,7 @@ public:
 
     void setUpdateTimeinfo(bool value);
     bool match(const QString& searchTerm, Qt::CaseSensitivity caseSensitivity);
+    bool match(const QStringList& wordList, Qt::CaseSensitivity caseSensitivity);
 
 Q_SIGNALS:
     /**
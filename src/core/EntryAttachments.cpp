@@ -17,11 +17,18 @@
 
 #include "EntryAttachments.h"
 
+#include "core/AttachmentStore.h"
+
 EntryAttachments::EntryAttachments(QObject* parent)
     : QObject(parent)
 {
 }
 
+EntryAttachments::~EntryAttachments()
+{
+    releaseAll();
+}
+
 QList<QString> EntryAttachments::keys() const
 {
     return m_attachments.keys();
@@ -29,15 +36,44 @@ QList<QString> EntryAttachments::keys() const
 
 QList<QByteArray> EntryAttachments::values() const
 {
-    return m_attachments.values();
+    QList<QByteArray> result;
+
+    QMap<QString, QByteArray>::const_iterator i;
+    for (i = m_attachments.constBegin(); i != m_attachments.constEnd(); ++i) {
+        result.append(attachmentStore()->data(i.value()));
+    }
+
+    return result;
 }
 
 QByteArray EntryAttachments::value(const QString& key) const
+{
+    QMap<QString, QByteArray>::const_iterator i = m_attachments.constFind(key);
+    if (i == m_attachments.constEnd()) {
+        return QByteArray();
+    }
+
+    return attachmentStore()->data(i.value());
+}
+
+QByteArray EntryAttachments::hash(const QString& key) const
 {
     return m_attachments.value(key);
 }
 
+QList<QByteArray> EntryAttachments::hashes() const
+{
+    return m_attachments.values();
+}
+
 void EntryAttachments::set(const QString& key, const QByteArray& value)
+{
+    QByteArray hash = attachmentStore()->add(value);
+    setHash(key, hash);
+    attachmentStore()->release(hash);
+}
+
+void EntryAttachments::setHash(const QString& key, const QByteArray& hash)
 {
     bool emitModified = false;
     bool addAttachment = !m_attachments.contains(key);
@@ -46,8 +82,12 @@ void EntryAttachments::set(const QString& key, const QByteArray& value)
         Q_EMIT aboutToBeAdded(key);
     }
 
-    if (addAttachment || m_attachments.value(key) != value) {
-        m_attachments.insert(key, value);
+    if (addAttachment || m_attachments.value(key) != hash) {
+        attachmentStore()->ref(hash);
+        if (!addAttachment) {
+            attachmentStore()->release(m_attachments.value(key));
+        }
+        m_attachments.insert(key, hash);
         emitModified = true;
     }
 
@@ -72,7 +112,7 @@ void EntryAttachments::remove(const QString& key)
 
     Q_EMIT aboutToBeRemoved(key);
 
-    m_attachments.remove(key);
+    attachmentStore()->release(m_attachments.take(key));
 
     Q_EMIT removed(key);
     Q_EMIT modified();
@@ -86,6 +126,7 @@ void EntryAttachments::clear()
 
     Q_EMIT aboutToBeReset();
 
+    releaseAll();
     m_attachments.clear();
 
     Q_EMIT reset();
@@ -97,6 +138,10 @@ void EntryAttachments::copyDataFrom(const EntryAttachments* other)
     if (*this != *other) {
         Q_EMIT aboutToBeReset();
 
+        Q_FOREACH (const QByteArray& hash, other->m_attachments) {
+            attachmentStore()->ref(hash);
+        }
+        releaseAll();
         m_attachments = other->m_attachments;
 
         Q_EMIT reset();
@@ -113,3 +158,17 @@ bool EntryAttachments::operator!=(const EntryAttachments& other) const
 {
     return m_attachments != other.m_attachments;
 }
+
+void EntryAttachments::releaseAll()
+{
+    AttachmentStore* store = attachmentStore();
+
+    // the store is already gone if this is called during application shutdown
+    if (!store) {
+        return;
+    }
+
+    Q_FOREACH (const QByteArray& hash, m_attachments) {
+        store->release(hash);
+    }
+}
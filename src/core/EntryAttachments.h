@@ -29,10 +29,14 @@ class EntryAttachments : public QObject
 
 public:
     explicit EntryAttachments(QObject* parent = Q_NULLPTR);
+    ~EntryAttachments();
     QList<QString> keys() const;
     QList<QByteArray> values() const;
     QByteArray value(const QString& key) const;
+    QByteArray hash(const QString& key) const;
+    QList<QByteArray> hashes() const;
     void set(const QString& key, const QByteArray& value);
+    void setHash(const QString& key, const QByteArray& hash);
     void remove(const QString& key);
     void clear();
     void copyDataFrom(const EntryAttachments* other);
@@ -50,6 +54,9 @@ Q_SIGNALS:
     void reset();
 
 private:
+    void releaseAll();
+
+    // maps attachment names to the hash of their data in the AttachmentStore
     QMap<QString, QByteArray> m_attachments;
 };
 
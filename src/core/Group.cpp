@@ -17,7 +17,6 @@
 
 #include "Group.h"
 
-#include "core/Config.h"
 #include "core/DatabaseIcons.h"
 #include "core/Metadata.h"
 #include "core/Tools.h"
@@ -48,6 +47,10 @@ Group::~Group()
         delete group;
     }
 
+    if (m_db) {
+        m_db->unindexGroup(this);
+    }
+
     if (m_db && m_parent) {
         DeletedObject delGroup;
         delGroup.deletionTime = Tools::currentDateTimeUtc();
@@ -184,7 +187,15 @@ bool Group::isExpired() const
 
 void Group::setUuid(const Uuid& uuid)
 {
+    if (m_db) {
+        m_db->unindexGroup(this);
+    }
+
     set(m_uuid, uuid);
+
+    if (m_db) {
+        m_db->indexGroup(this);
+    }
 }
 
 void Group::setName(const QString& name)
@@ -236,12 +247,12 @@ void Group::setTimeInfo(const TimeInfo& timeInfo)
     m_data.timeInfo = timeInfo;
 }
 
-void Group::setExpanded(bool expanded)
+void Group::setExpanded(bool expanded, bool emitModified)
 {
     if (m_data.isExpanded != expanded) {
         m_data.isExpanded = expanded;
         updateTimeinfo();
-        if (config()->get("ModifiedOnExpandedStateChanges").toBool()) {
+        if (emitModified) {
             Q_EMIT modified();
         }
     }
@@ -507,6 +518,7 @@ void Group::addEntry(Entry* entry)
     connect(entry, SIGNAL(dataChanged(Entry*)), SIGNAL(entryDataChanged(Entry*)));
     if (m_db) {
         connect(entry, SIGNAL(modified()), m_db, SIGNAL(modifiedImmediate()));
+        m_db->indexEntry(entry);
     }
 
     Q_EMIT modified();
@@ -522,6 +534,7 @@ void Group::removeEntry(Entry* entry)
     entry->disconnect(this);
     if (m_db) {
         entry->disconnect(m_db);
+        m_db->unindexEntry(entry);
     }
     m_entries.removeAll(entry);
     Q_EMIT modified();
@@ -538,15 +551,23 @@ void Group::recSetDatabase(Database* db)
         disconnect(SIGNAL(added()), m_db);
         disconnect(SIGNAL(aboutToMove(Group*,Group*,int)), m_db);
         disconnect(SIGNAL(moved()), m_db);
+        disconnect(SIGNAL(entryAboutToAdd(Entry*)), m_db);
+        disconnect(SIGNAL(entryAdded(Entry*)), m_db);
+        disconnect(SIGNAL(entryAboutToRemove(Entry*)), m_db);
+        disconnect(SIGNAL(entryRemoved(Entry*)), m_db);
+        disconnect(SIGNAL(entryDataChanged(Entry*)), m_db);
         disconnect(SIGNAL(modified()), m_db);
+        m_db->unindexGroup(this);
     }
 
     Q_FOREACH (Entry* entry, m_entries) {
         if (m_db) {
             entry->disconnect(m_db);
+            m_db->unindexEntry(entry);
         }
         if (db) {
             connect(entry, SIGNAL(modified()), db, SIGNAL(modifiedImmediate()));
+            db->indexEntry(entry);
         }
     }
 
@@ -558,7 +579,13 @@ void Group::recSetDatabase(Database* db)
         connect(this, SIGNAL(added()), db, SIGNAL(groupAdded()));
         connect(this, SIGNAL(aboutToMove(Group*,Group*,int)), db, SIGNAL(groupAboutToMove(Group*,Group*,int)));
         connect(this, SIGNAL(moved()), db, SIGNAL(groupMoved()));
+        connect(this, SIGNAL(entryAboutToAdd(Entry*)), db, SIGNAL(entryAboutToAdd(Entry*)));
+        connect(this, SIGNAL(entryAdded(Entry*)), db, SIGNAL(entryAdded(Entry*)));
+        connect(this, SIGNAL(entryAboutToRemove(Entry*)), db, SIGNAL(entryAboutToRemove(Entry*)));
+        connect(this, SIGNAL(entryRemoved(Entry*)), db, SIGNAL(entryRemoved(Entry*)));
+        connect(this, SIGNAL(entryDataChanged(Entry*)), db, SIGNAL(entryDataChanged(Entry*)));
         connect(this, SIGNAL(modified()), db, SIGNAL(modifiedImmediate()));
+        db->indexGroup(this);
     }
 
     m_db = db;
@@ -596,19 +623,52 @@ QList<Entry*> Group::search(const QString& searchTerm, Qt::CaseSensitivity caseS
                             bool resolveInherit)
 {
     QList<Entry*> searchResult;
-    if (includeInSearch(resolveInherit)) {
-        Q_FOREACH (Entry* entry, m_entries) {
-            if (entry->match(searchTerm, caseSensitivity)) {
-                searchResult.append(entry);
+    if (!includeInSearch(resolveInherit)) {
+        return searchResult;
+    }
+
+    QStringList wordList = searchTerm.split(QRegExp("\\s"), QString::SkipEmptyParts);
+    QSet<Entry*> candidates;
+
+    if (m_db && m_db->m_searchIndex->findCandidates(wordList, candidates)) {
+        // only descend into groups that contain candidates
+        QSet<const Group*> candidateGroups;
+        Q_FOREACH (Entry* entry, candidates) {
+            const Group* group = entry->group();
+            while (group && !candidateGroups.contains(group)) {
+                candidateGroups.insert(group);
+                group = group->parentGroup();
             }
         }
-        Q_FOREACH (Group* group, m_children) {
-            searchResult.append(group->search(searchTerm, caseSensitivity, false));
+
+        if (candidateGroups.contains(this)) {
+            recSearch(wordList, caseSensitivity, &candidates, &candidateGroups, searchResult);
         }
     }
+    else {
+        recSearch(wordList, caseSensitivity, Q_NULLPTR, Q_NULLPTR, searchResult);
+    }
+
     return searchResult;
 }
 
+void Group::recSearch(const QStringList& wordList, Qt::CaseSensitivity caseSensitivity,
+                      const QSet<Entry*>* candidates, const QSet<const Group*>* candidateGroups,
+                      QList<Entry*>& searchResult)
+{
+    Q_FOREACH (Entry* entry, m_entries) {
+        if ((!candidates || candidates->contains(entry)) && entry->match(wordList, caseSensitivity)) {
+            searchResult.append(entry);
+        }
+    }
+
+    Q_FOREACH (Group* group, m_children) {
+        if ((!candidateGroups || candidateGroups->contains(group)) && group->includeInSearch(false)) {
+            group->recSearch(wordList, caseSensitivity, candidates, candidateGroups, searchResult);
+        }
+    }
+}
+
 bool Group::includeInSearch(bool resolveInherit)
 {
     switch (m_data.searchingEnabled) {
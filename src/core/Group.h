@@ -77,7 +77,7 @@ public:
     void setIcon(int iconNumber);
     void setIcon(const Uuid& uuid);
     void setTimeInfo(const TimeInfo& timeInfo);
-    void setExpanded(bool expanded);
+    void setExpanded(bool expanded, bool emitModified = true);
     void setDefaultAutoTypeSequence(const QString& sequence);
     void setAutoTypeEnabled(TriState enable);
     void setSearchingEnabled(TriState enable);
@@ -140,6 +140,9 @@ private:
     void recCreateDelObjects();
     void updateTimeinfo();
     bool includeInSearch(bool resolveInherit);
+    void recSearch(const QStringList& wordList, Qt::CaseSensitivity caseSensitivity,
+                   const QSet<Entry*>* candidates, const QSet<const Group*>* candidateGroups,
+                   QList<Entry*>& searchResult);
 
     QPointer<Database> m_db;
     Uuid m_uuid;
@@ -17,58 +17,153 @@
 
 #include "PasswordGenerator.h"
 
+#include <cstring>
+
 #include "crypto/Random.h"
 
+/**
+ * Hands out unbiased random indices from one bulk random buffer.
+ */
+class RandomIndexBuffer
+{
+public:
+    explicit RandomIndexBuffer(qint64 expectedCount);
+    ~RandomIndexBuffer();
+
+    /**
+     * Returns a random int in the range [0, @p limit)
+     */
+    int index(int limit);
+
+private:
+    void refill(qint64 count);
+
+    static const int MaxBufferSize = 64 * 1024;
+
+    QByteArray m_buffer;
+    int m_pos;
+};
+
+RandomIndexBuffer::RandomIndexBuffer(qint64 expectedCount)
+    : m_pos(0)
+{
+    // a few spare values for the rare rejections
+    refill(expectedCount + 16);
+}
+
+RandomIndexBuffer::~RandomIndexBuffer()
+{
+    memset(m_buffer.data(), 0, m_buffer.size());
+}
+
+int RandomIndexBuffer::index(int limit)
+{
+    Q_ASSERT(limit > 0);
+
+    const quint32 ulimit = static_cast<quint32>(limit);
+    const quint32 threshold = Random::rejectionThreshold(ulimit);
+
+    quint32 value;
+    do {
+        if (m_pos + 4 > m_buffer.size()) {
+            refill(256);
+        }
+
+        memcpy(&value, m_buffer.constData() + m_pos, 4);
+        m_pos += 4;
+    } while (value < threshold);
+
+    return static_cast<int>(value % ulimit);
+}
+
+void RandomIndexBuffer::refill(qint64 count)
+{
+    memset(m_buffer.data(), 0, m_buffer.size());
+
+    m_buffer = Random::randomArray(static_cast<int>(qMin<qint64>(count * 4, MaxBufferSize)));
+    m_pos = 0;
+}
+
 PasswordGenerator* PasswordGenerator::m_instance = Q_NULLPTR;
 
 QString PasswordGenerator::generatePassword(int length,
                                             const PasswordGenerator::CharClasses& classes,
                                             const PasswordGenerator::GeneratorFlags& flags)
+{
+    return generatePasswords(compileProfile(length, classes, flags), 1).first();
+}
+
+PasswordGenerator::Profile PasswordGenerator::compileProfile(int length,
+                                                             const PasswordGenerator::CharClasses& classes,
+                                                             const PasswordGenerator::GeneratorFlags& flags)
 {
     Q_ASSERT(isValidCombination(length, classes, flags));
 
-    QVector<PasswordGroup> groups = passwordGroups(classes, flags);
+    Profile profile;
+    profile.length = length;
+    profile.flags = flags;
+    profile.groups = passwordGroups(classes, flags);
 
-    QVector<QChar> passwordChars;
-    Q_FOREACH (const PasswordGroup& group, groups) {
-        Q_FOREACH (QChar ch, group) {
-            passwordChars.append(ch);
-        }
+    Q_FOREACH (const PasswordGroup& group, profile.groups) {
+        profile.chars += group;
     }
 
-    QString password;
+    return profile;
+}
 
-    if (flags & CharFromEveryGroup) {
-        for (int i = 0; i < groups.size(); i++) {
-            int pos = Random::randomUInt(groups[i].size());
+QStringList PasswordGenerator::generatePasswords(const PasswordGenerator::Profile& profile, int count)
+{
+    Q_ASSERT(count >= 0);
+    Q_ASSERT(profile.length > 0);
+    Q_ASSERT(!profile.chars.isEmpty());
 
-            password.append(groups[i][pos]);
-        }
+    const bool fromEveryGroup = profile.flags & CharFromEveryGroup;
 
-        for (int i = groups.size(); i < length; i++) {
-            int pos = Random::randomUInt(passwordChars.size());
+    // every char and every shuffle step takes one random value (not counting rejections)
+    qint64 valuesPerPassword = fromEveryGroup ? (2 * profile.length - 1) : profile.length;
+    RandomIndexBuffer random(valuesPerPassword * count);
 
-            password.append(passwordChars[pos]);
-        }
+    QStringList passwords;
+    passwords.reserve(count);
 
-        // shuffle chars
-        for (int i = (password.size() - 1); i >= 1; i--) {
-            int j = Random::randomUInt(i + 1);
+    for (int n = 0; n < count; n++) {
+        QString password;
+        password.reserve(profile.length);
 
-            QChar tmp = password[i];
-            password[i] = password[j];
-            password[j] = tmp;
+        if (fromEveryGroup) {
+            for (int i = 0; i < profile.groups.size(); i++) {
+                int pos = random.index(profile.groups[i].size());
+
+                password.append(profile.groups[i][pos]);
+            }
+
+            for (int i = profile.groups.size(); i < profile.length; i++) {
+                int pos = random.index(profile.chars.size());
+
+                password.append(profile.chars[pos]);
+            }
+
+            // shuffle chars
+            for (int i = (password.size() - 1); i >= 1; i--) {
+                int j = random.index(i + 1);
+
+                QChar tmp = password[i];
+                password[i] = password[j];
+                password[j] = tmp;
+            }
         }
-    }
-    else {
-        for (int i = 0; i < length; i++) {
-            int pos = Random::randomUInt(passwordChars.size());
+        else {
+            for (int i = 0; i < profile.length; i++) {
+                int pos = random.index(profile.chars.size());
 
-            password.append(passwordChars[pos]);
+                password.append(profile.chars[pos]);
+            }
         }
+
+        passwords.append(password);
     }
 
-    return password;
+    return passwords;
 }
 
 bool PasswordGenerator::isValidCombination(int length,
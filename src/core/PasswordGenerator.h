@@ -20,6 +20,7 @@
 
 #include <QtCore/QFlags>
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 #include <QtCore/QVector>
 
 #include "core/Global.h"
@@ -45,8 +46,23 @@ public:
     };
     Q_DECLARE_FLAGS(GeneratorFlags, GeneratorFlag)
 
+    /**
+     * Character groups of a generator configuration, computed once
+     * so that it can be used for many passwords.
+     */
+    struct Profile
+    {
+        int length;
+        PasswordGenerator::GeneratorFlags flags;
+        QVector<PasswordGroup> groups;
+        PasswordGroup chars;
+    };
+
     QString generatePassword(int length, const PasswordGenerator::CharClasses& classes,
                              const PasswordGenerator::GeneratorFlags& flags);
+    Profile compileProfile(int length, const PasswordGenerator::CharClasses& classes,
+                           const PasswordGenerator::GeneratorFlags& flags);
+    QStringList generatePasswords(const Profile& profile, int count);
     bool isValidCombination(int length, const PasswordGenerator::CharClasses& classes,
                             const PasswordGenerator::GeneratorFlags& flags);
 
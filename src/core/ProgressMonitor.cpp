@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ProgressMonitor.h"
+
+ProgressMonitor::ProgressMonitor(QObject* parent)
+    : QObject(parent)
+    , m_stageBegin(0)
+    , m_stageEnd(100)
+    , m_progress(0)
+    , m_canceled(0)
+{
+}
+
+/**
+ * Maps the following setStageProgress() calls to the percent range [begin, end].
+ */
+void ProgressMonitor::setStage(int begin, int end)
+{
+    Q_ASSERT(begin >= 0 && begin <= end && end <= 100);
+
+    m_stageBegin.store(begin);
+    m_stageEnd.store(end);
+    setStageProgress(0, 1);
+}
+
+void ProgressMonitor::setStageProgress(qint64 done, qint64 total)
+{
+    int begin = m_stageBegin.load();
+    int end = m_stageEnd.load();
+
+    int percent = end;
+    if (total > 0 && done < total) {
+        percent = begin + static_cast<int>((end - begin) * (static_cast<double>(done) / total));
+    }
+
+    if (m_progress.fetchAndStoreOrdered(percent) != percent) {
+        Q_EMIT progressChanged(percent);
+    }
+}
+
+int ProgressMonitor::progress() const
+{
+    return m_progress.load();
+}
+
+void ProgressMonitor::cancel()
+{
+    m_canceled.store(1);
+}
+
+bool ProgressMonitor::isCanceled() const
+{
+    return m_canceled.load() != 0;
+}
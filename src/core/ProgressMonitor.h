@@ -0,0 +1,56 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_PROGRESSMONITOR_H
+#define KEEPASSX_PROGRESSMONITOR_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QObject>
+
+#include "core/Global.h"
+
+/**
+ * Reports the progress of a long running operation and allows to cancel it.
+ *
+ * The operation may run in any thread; progressChanged() is delivered
+ * through a queued connection to receivers living in other threads.
+ */
+class ProgressMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProgressMonitor(QObject* parent = Q_NULLPTR);
+
+    void setStage(int begin, int end);
+    void setStageProgress(qint64 done, qint64 total);
+    int progress() const;
+
+    void cancel();
+    bool isCanceled() const;
+
+Q_SIGNALS:
+    void progressChanged(int percent);
+
+private:
+    QAtomicInt m_stageBegin;
+    QAtomicInt m_stageEnd;
+    QAtomicInt m_progress;
+    QAtomicInt m_canceled;
+};
+
+#endif // KEEPASSX_PROGRESSMONITOR_H
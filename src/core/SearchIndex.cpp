@@ -0,0 +1,190 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SearchIndex.h"
+
+#include "core/Entry.h"
+
+SearchIndex::SearchIndex(QObject* parent)
+    : QObject(parent)
+    , m_deadSlots(0)
+{
+}
+
+void SearchIndex::addEntry(Entry* entry)
+{
+    insertSlot(entry);
+    connect(entry, SIGNAL(dataChanged(Entry*)), SLOT(updateEntry(Entry*)));
+}
+
+void SearchIndex::removeEntry(Entry* entry)
+{
+    disconnect(entry, SIGNAL(dataChanged(Entry*)), this, SLOT(updateEntry(Entry*)));
+    releaseSlot(entry);
+
+    if (m_deadSlots > 1000 && m_deadSlots > m_slotOfEntry.size()) {
+        compact();
+    }
+}
+
+void SearchIndex::updateEntry(Entry* entry)
+{
+    // the entry gets a new slot so the posting lists stay sorted
+    releaseSlot(entry);
+    insertSlot(entry);
+
+    if (m_deadSlots > 1000 && m_deadSlots > m_slotOfEntry.size()) {
+        compact();
+    }
+}
+
+bool SearchIndex::findCandidates(const QStringList& wordList, QSet<Entry*>& candidates) const
+{
+    QVector<int> slotList;
+    bool filtered = false;
+
+    Q_FOREACH (const QString& word, wordList) {
+        QString foldedWord = word.toCaseFolded();
+
+        for (int i = 0; i + 3 <= foldedWord.size(); i++) {
+            QHash<Trigram, QVector<int> >::const_iterator it = m_postings.constFind(trigram(foldedWord, i));
+
+            if (it == m_postings.constEnd()) {
+                slotList.clear();
+            }
+            else if (!filtered) {
+                slotList = it.value();
+            }
+            else {
+                slotList = intersect(slotList, it.value());
+            }
+
+            filtered = true;
+
+            if (slotList.isEmpty()) {
+                candidates.clear();
+                return true;
+            }
+        }
+    }
+
+    if (!filtered) {
+        return false;
+    }
+
+    candidates.clear();
+    candidates.reserve(slotList.size());
+    Q_FOREACH (int slot, slotList) {
+        Entry* entry = m_slots.at(slot);
+        if (entry) {
+            candidates.insert(entry);
+        }
+    }
+
+    return true;
+}
+
+void SearchIndex::insertSlot(Entry* entry)
+{
+    Q_ASSERT(!m_slotOfEntry.contains(entry));
+
+    int slot = m_slots.size();
+    m_slots.append(entry);
+    m_slotOfEntry.insert(entry, slot);
+
+    QSet<Trigram> trigrams;
+    addTrigrams(entry->title(), trigrams);
+    addTrigrams(entry->username(), trigrams);
+    addTrigrams(entry->url(), trigrams);
+    addTrigrams(entry->notes(), trigrams);
+
+    Q_FOREACH (Trigram t, trigrams) {
+        m_postings[t].append(slot);
+    }
+}
+
+void SearchIndex::releaseSlot(Entry* entry)
+{
+    QHash<Entry*, int>::iterator it = m_slotOfEntry.find(entry);
+    if (it == m_slotOfEntry.end()) {
+        return;
+    }
+
+    m_slots[it.value()] = Q_NULLPTR;
+    m_slotOfEntry.erase(it);
+    m_deadSlots++;
+}
+
+void SearchIndex::compact()
+{
+    QList<Entry*> entries;
+    Q_FOREACH (Entry* entry, m_slots) {
+        if (entry) {
+            entries.append(entry);
+        }
+    }
+
+    m_slots.clear();
+    m_slotOfEntry.clear();
+    m_postings.clear();
+    m_deadSlots = 0;
+
+    Q_FOREACH (Entry* entry, entries) {
+        insertSlot(entry);
+    }
+}
+
+void SearchIndex::addTrigrams(const QString& text, QSet<Trigram>& trigrams)
+{
+    QString foldedText = text.toCaseFolded();
+
+    for (int i = 0; i + 3 <= foldedText.size(); i++) {
+        trigrams.insert(trigram(foldedText, i));
+    }
+}
+
+SearchIndex::Trigram SearchIndex::trigram(const QString& foldedText, int pos)
+{
+    return (static_cast<Trigram>(foldedText.at(pos).unicode()) << 32)
+            | (static_cast<Trigram>(foldedText.at(pos + 1).unicode()) << 16)
+            | static_cast<Trigram>(foldedText.at(pos + 2).unicode());
+}
+
+QVector<int> SearchIndex::intersect(const QVector<int>& list1, const QVector<int>& list2)
+{
+    QVector<int> result;
+    result.reserve(qMin(list1.size(), list2.size()));
+
+    int i1 = 0;
+    int i2 = 0;
+
+    while (i1 < list1.size() && i2 < list2.size()) {
+        if (list1.at(i1) < list2.at(i2)) {
+            i1++;
+        }
+        else if (list2.at(i2) < list1.at(i1)) {
+            i2++;
+        }
+        else {
+            result.append(list1.at(i1));
+            i1++;
+            i2++;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_SEARCHINDEX_H
+#define KEEPASSX_SEARCHINDEX_H
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QSet>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "core/Global.h"
+
+class Entry;
+
+/**
+ * Trigram index over the searchable attributes of all entries in a database.
+ * It only narrows down the entries that can match a search, callers still
+ * have to verify the candidates with Entry::match().
+ */
+class SearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SearchIndex(QObject* parent = Q_NULLPTR);
+
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+
+    /**
+     * Collects the entries that can contain all words of wordList.
+     * Returns false if the words are too short to narrow down the search,
+     * candidates is left untouched in that case.
+     */
+    bool findCandidates(const QStringList& wordList, QSet<Entry*>& candidates) const;
+
+private Q_SLOTS:
+    void updateEntry(Entry* entry);
+
+private:
+    typedef quint64 Trigram;
+
+    void insertSlot(Entry* entry);
+    void releaseSlot(Entry* entry);
+    void compact();
+
+    static void addTrigrams(const QString& text, QSet<Trigram>& trigrams);
+    static Trigram trigram(const QString& foldedText, int pos);
+    static QVector<int> intersect(const QVector<int>& list1, const QVector<int>& list2);
+
+    // entries are appended to m_slots and every posting list is sorted by slot,
+    // slots of removed or changed entries are set to null until the next compact()
+    QVector<Entry*> m_slots;
+    QHash<Entry*, int> m_slotOfEntry;
+    QHash<Trigram, QVector<int> > m_postings;
+    int m_deadSlots;
+};
+
+#endif // KEEPASSX_SEARCHINDEX_H
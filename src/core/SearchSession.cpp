@@ -0,0 +1,103 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SearchSession.h"
+
+#include <QtCore/QRegExp>
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Group.h"
+
+SearchSession::SearchSession(QObject* parent)
+    : QObject(parent)
+    , m_caseSensitivity(Qt::CaseInsensitive)
+    , m_hasResult(false)
+{
+}
+
+QList<Entry*> SearchSession::search(Group* group, const QString& searchTerm,
+                                    Qt::CaseSensitivity caseSensitivity)
+{
+    // split the same way as Group::search() and Entry::match()
+    QStringList wordList = searchTerm.split(QRegExp("\\s"), QString::SkipEmptyParts);
+
+    if (m_hasResult && group == m_group && caseSensitivity == m_caseSensitivity
+            && isRefinement(m_wordList, wordList, caseSensitivity)) {
+        QList<Entry*> result;
+        Q_FOREACH (Entry* entry, m_result) {
+            if (entry->match(wordList, caseSensitivity)) {
+                result.append(entry);
+            }
+        }
+        m_result = result;
+    }
+    else {
+        reset();
+
+        // without a database nothing tells us when the results become stale
+        if (!group->database()) {
+            return group->search(searchTerm, caseSensitivity);
+        }
+
+        m_result = group->search(searchTerm, caseSensitivity);
+        m_group = group;
+        m_db = group->database();
+        connect(m_db, SIGNAL(modifiedImmediate()), SLOT(reset()));
+        m_hasResult = true;
+    }
+
+    m_wordList = wordList;
+    m_caseSensitivity = caseSensitivity;
+
+    return m_result;
+}
+
+bool SearchSession::isRefinement(const QStringList& oldWordList, const QStringList& newWordList,
+                                 Qt::CaseSensitivity caseSensitivity)
+{
+    // an entry contains every word that is part of a word it contains
+    Q_FOREACH (const QString& oldWord, oldWordList) {
+        bool found = false;
+
+        Q_FOREACH (const QString& newWord, newWordList) {
+            if (newWord.contains(oldWord, caseSensitivity)) {
+                found = true;
+                break;
+            }
+        }
+
+        if (!found) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SearchSession::reset()
+{
+    if (m_db) {
+        disconnect(m_db, Q_NULLPTR, this, Q_NULLPTR);
+    }
+
+    m_group = Q_NULLPTR;
+    m_db = Q_NULLPTR;
+    m_wordList.clear();
+    m_result.clear();
+    m_hasResult = false;
+}
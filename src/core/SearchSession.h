@@ -0,0 +1,66 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_SEARCHSESSION_H
+#define KEEPASSX_SEARCHSESSION_H
+
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+#include <QtCore/QStringList>
+
+#include "core/Global.h"
+
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Remembers the last search so that a query which only narrows it down
+ * filters the previous results instead of searching the group again.
+ * The results are dropped whenever the database is modified.
+ */
+class SearchSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SearchSession(QObject* parent = Q_NULLPTR);
+
+    /**
+     * Same result as Group::search().
+     */
+    QList<Entry*> search(Group* group, const QString& searchTerm, Qt::CaseSensitivity caseSensitivity);
+
+    /**
+     * Returns true if every entry that matches newWordList also matches oldWordList.
+     */
+    static bool isRefinement(const QStringList& oldWordList, const QStringList& newWordList,
+                             Qt::CaseSensitivity caseSensitivity);
+
+public Q_SLOTS:
+    void reset();
+
+private:
+    QPointer<Group> m_group;
+    QPointer<Database> m_db;
+    QStringList m_wordList;
+    Qt::CaseSensitivity m_caseSensitivity;
+    QList<Entry*> m_result;
+    bool m_hasResult;
+};
+
+#endif // KEEPASSX_SEARCHSESSION_H
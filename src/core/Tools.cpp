@@ -245,4 +245,14 @@ void disableCoreDumps()
     }
 }
 
+void wipeMemory(void* data, int size)
+{
+    // the compiler may drop a memset() of memory that isn't read afterwards,
+    // but not the stores through a volatile pointer
+    volatile char* p = static_cast<volatile char*>(data);
+    for (int i = 0; i < size; i++) {
+        p[i] = 0;
+    }
+}
+
 } // namespace Tools
@@ -39,6 +39,7 @@ void sleep(int ms);
 void wait(int ms);
 QString platform();
 void disableCoreDumps();
+void wipeMemory(void* data, int size);
 
 } // namespace Tools
 
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AesKeyTransform.h"
+
+#include "config-keepassx.h"
+#include "core/Tools.h"
+#include "crypto/SymmetricCipher.h"
+
+#ifdef HAVE_AESNI
+#include <cpuid.h>
+#endif
+
+AesKeyTransform::AesKeyTransform(const QByteArray& seed, Backend backend)
+    : m_useAesNi(backend == BackendAesNi || (backend == BackendAuto && hasAesNi()))
+{
+    Q_ASSERT(seed.size() == 32);
+    Q_ASSERT(isBackendAvailable(backend));
+
+    if (m_useAesNi) {
+        expandKeyAesNi(seed.constData(), m_roundKeys);
+    }
+    else {
+        m_cipher.reset(new SymmetricCipher(SymmetricCipher::Aes256, SymmetricCipher::Ecb,
+                                           SymmetricCipher::Encrypt, seed, QByteArray(16, 0)));
+    }
+}
+
+AesKeyTransform::~AesKeyTransform()
+{
+    Tools::wipeMemory(m_roundKeys, RoundKeysSize);
+}
+
+void AesKeyTransform::transform(QByteArray& data, quint64 rounds)
+{
+    Q_ASSERT(data.size() == 16 || data.size() == 32);
+
+    if (rounds == 0) {
+        return;
+    }
+
+    if (m_useAesNi) {
+        if (data.size() == 32) {
+            encryptTwoBlocksAesNi(m_roundKeys, data.data(), rounds);
+        }
+        else {
+            encryptAesNi(m_roundKeys, data.data(), rounds);
+        }
+    }
+    else {
+        m_cipher->processInPlace(data, rounds);
+    }
+}
+
+bool AesKeyTransform::hasAesNi()
+{
+#ifdef HAVE_AESNI
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+
+    return (ecx & bit_AES) != 0;
+#else
+    return false;
+#endif
+}
+
+bool AesKeyTransform::isBackendAvailable(Backend backend)
+{
+    if (backend == BackendAesNi) {
+        return hasAesNi();
+    }
+    else {
+        return true;
+    }
+}
+
+#ifndef HAVE_AESNI
+void AesKeyTransform::expandKeyAesNi(const char* key, char* roundKeys)
+{
+    Q_UNUSED(key);
+    Q_UNUSED(roundKeys);
+    Q_ASSERT(false);
+}
+
+void AesKeyTransform::encryptAesNi(const char* roundKeys, char* data, quint64 rounds)
+{
+    Q_UNUSED(roundKeys);
+    Q_UNUSED(data);
+    Q_UNUSED(rounds);
+    Q_ASSERT(false);
+}
+
+void AesKeyTransform::encryptTwoBlocksAesNi(const char* roundKeys, char* data, quint64 rounds)
+{
+    Q_UNUSED(roundKeys);
+    Q_UNUSED(data);
+    Q_UNUSED(rounds);
+    Q_ASSERT(false);
+}
+#endif
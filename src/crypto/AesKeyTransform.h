@@ -0,0 +1,74 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_AESKEYTRANSFORM_H
+#define KEEPASSX_AESKEYTRANSFORM_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QScopedPointer>
+
+#include "core/Global.h"
+
+class SymmetricCipher;
+
+/**
+ * Repeated AES-256-ECB encryption of one or two 16 byte blocks as used by the
+ * KeePass key transformation.
+ *
+ * Uses an AES-NI kernel if the CPU supports it and falls back to libgcrypt otherwise.
+ */
+class AesKeyTransform
+{
+public:
+    enum Backend
+    {
+        BackendAuto,
+        BackendGcrypt,
+        BackendAesNi
+    };
+
+    /**
+     * BackendAuto picks the fastest available backend.
+     * Requesting an unavailable backend is an error.
+     */
+    explicit AesKeyTransform(const QByteArray& seed, Backend backend = BackendAuto);
+    ~AesKeyTransform();
+
+    /**
+     * @p data has to be 16 or 32 bytes long. With AES-NI both blocks of
+     * a 32 byte key are encrypted interleaved on the calling thread.
+     */
+    void transform(QByteArray& data, quint64 rounds);
+
+    static bool hasAesNi();
+    static bool isBackendAvailable(Backend backend);
+
+private:
+    static void expandKeyAesNi(const char* key, char* roundKeys);
+    static void encryptAesNi(const char* roundKeys, char* data, quint64 rounds);
+    static void encryptTwoBlocksAesNi(const char* roundKeys, char* data, quint64 rounds);
+
+    static const int RoundKeysSize = 15 * 16;
+
+    const bool m_useAesNi;
+    char m_roundKeys[RoundKeysSize];
+    QScopedPointer<SymmetricCipher> m_cipher;
+
+    Q_DISABLE_COPY(AesKeyTransform)
+};
+
+#endif // KEEPASSX_AESKEYTRANSFORM_H
@@ -0,0 +1,171 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AesKeyTransform.h"
+
+#include <wmmintrin.h>
+
+// Only compiled when the compiler supports AES-NI (HAVE_AESNI).
+// The functions must not be called unless AesKeyTransform::hasAesNi() returns true.
+
+static inline __m128i expandKeyEven(__m128i key, __m128i keygen)
+{
+    keygen = _mm_shuffle_epi32(keygen, 0xff);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, keygen);
+}
+
+static inline __m128i expandKeyOdd(__m128i key, __m128i previous)
+{
+    __m128i keygen = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(previous, 0x00), 0xaa);
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    key = _mm_xor_si128(key, _mm_slli_si128(key, 4));
+    return _mm_xor_si128(key, keygen);
+}
+
+void AesKeyTransform::expandKeyAesNi(const char* key, char* roundKeys)
+{
+    __m128i k[15];
+
+    k[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+    k[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + 16));
+    k[2] = expandKeyEven(k[0], _mm_aeskeygenassist_si128(k[1], 0x01));
+    k[3] = expandKeyOdd(k[1], k[2]);
+    k[4] = expandKeyEven(k[2], _mm_aeskeygenassist_si128(k[3], 0x02));
+    k[5] = expandKeyOdd(k[3], k[4]);
+    k[6] = expandKeyEven(k[4], _mm_aeskeygenassist_si128(k[5], 0x04));
+    k[7] = expandKeyOdd(k[5], k[6]);
+    k[8] = expandKeyEven(k[6], _mm_aeskeygenassist_si128(k[7], 0x08));
+    k[9] = expandKeyOdd(k[7], k[8]);
+    k[10] = expandKeyEven(k[8], _mm_aeskeygenassist_si128(k[9], 0x10));
+    k[11] = expandKeyOdd(k[9], k[10]);
+    k[12] = expandKeyEven(k[10], _mm_aeskeygenassist_si128(k[11], 0x20));
+    k[13] = expandKeyOdd(k[11], k[12]);
+    k[14] = expandKeyEven(k[12], _mm_aeskeygenassist_si128(k[13], 0x40));
+
+    for (int i = 0; i < 15; i++) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(roundKeys + i * 16), k[i]);
+        k[i] = _mm_setzero_si128();
+    }
+}
+
+void AesKeyTransform::encryptAesNi(const char* roundKeys, char* data, quint64 rounds)
+{
+    // keep all round keys in registers for the whole loop
+    const __m128i* keys = reinterpret_cast<const __m128i*>(roundKeys);
+    const __m128i k0 = _mm_loadu_si128(keys);
+    const __m128i k1 = _mm_loadu_si128(keys + 1);
+    const __m128i k2 = _mm_loadu_si128(keys + 2);
+    const __m128i k3 = _mm_loadu_si128(keys + 3);
+    const __m128i k4 = _mm_loadu_si128(keys + 4);
+    const __m128i k5 = _mm_loadu_si128(keys + 5);
+    const __m128i k6 = _mm_loadu_si128(keys + 6);
+    const __m128i k7 = _mm_loadu_si128(keys + 7);
+    const __m128i k8 = _mm_loadu_si128(keys + 8);
+    const __m128i k9 = _mm_loadu_si128(keys + 9);
+    const __m128i k10 = _mm_loadu_si128(keys + 10);
+    const __m128i k11 = _mm_loadu_si128(keys + 11);
+    const __m128i k12 = _mm_loadu_si128(keys + 12);
+    const __m128i k13 = _mm_loadu_si128(keys + 13);
+    const __m128i k14 = _mm_loadu_si128(keys + 14);
+
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+
+    for (quint64 i = 0; i != rounds; ++i) {
+        block = _mm_xor_si128(block, k0);
+        block = _mm_aesenc_si128(block, k1);
+        block = _mm_aesenc_si128(block, k2);
+        block = _mm_aesenc_si128(block, k3);
+        block = _mm_aesenc_si128(block, k4);
+        block = _mm_aesenc_si128(block, k5);
+        block = _mm_aesenc_si128(block, k6);
+        block = _mm_aesenc_si128(block, k7);
+        block = _mm_aesenc_si128(block, k8);
+        block = _mm_aesenc_si128(block, k9);
+        block = _mm_aesenc_si128(block, k10);
+        block = _mm_aesenc_si128(block, k11);
+        block = _mm_aesenc_si128(block, k12);
+        block = _mm_aesenc_si128(block, k13);
+        block = _mm_aesenclast_si128(block, k14);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data), block);
+}
+
+void AesKeyTransform::encryptTwoBlocksAesNi(const char* roundKeys, char* data, quint64 rounds)
+{
+    // The blocks are independent so the latency of one aesenc is hidden
+    // behind the other one, this is almost twice as fast as two separate calls.
+    const __m128i* keys = reinterpret_cast<const __m128i*>(roundKeys);
+    const __m128i k0 = _mm_loadu_si128(keys);
+    const __m128i k1 = _mm_loadu_si128(keys + 1);
+    const __m128i k2 = _mm_loadu_si128(keys + 2);
+    const __m128i k3 = _mm_loadu_si128(keys + 3);
+    const __m128i k4 = _mm_loadu_si128(keys + 4);
+    const __m128i k5 = _mm_loadu_si128(keys + 5);
+    const __m128i k6 = _mm_loadu_si128(keys + 6);
+    const __m128i k7 = _mm_loadu_si128(keys + 7);
+    const __m128i k8 = _mm_loadu_si128(keys + 8);
+    const __m128i k9 = _mm_loadu_si128(keys + 9);
+    const __m128i k10 = _mm_loadu_si128(keys + 10);
+    const __m128i k11 = _mm_loadu_si128(keys + 11);
+    const __m128i k12 = _mm_loadu_si128(keys + 12);
+    const __m128i k13 = _mm_loadu_si128(keys + 13);
+    const __m128i k14 = _mm_loadu_si128(keys + 14);
+
+    __m128i block1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    __m128i block2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16));
+
+    for (quint64 i = 0; i != rounds; ++i) {
+        block1 = _mm_xor_si128(block1, k0);
+        block2 = _mm_xor_si128(block2, k0);
+        block1 = _mm_aesenc_si128(block1, k1);
+        block2 = _mm_aesenc_si128(block2, k1);
+        block1 = _mm_aesenc_si128(block1, k2);
+        block2 = _mm_aesenc_si128(block2, k2);
+        block1 = _mm_aesenc_si128(block1, k3);
+        block2 = _mm_aesenc_si128(block2, k3);
+        block1 = _mm_aesenc_si128(block1, k4);
+        block2 = _mm_aesenc_si128(block2, k4);
+        block1 = _mm_aesenc_si128(block1, k5);
+        block2 = _mm_aesenc_si128(block2, k5);
+        block1 = _mm_aesenc_si128(block1, k6);
+        block2 = _mm_aesenc_si128(block2, k6);
+        block1 = _mm_aesenc_si128(block1, k7);
+        block2 = _mm_aesenc_si128(block2, k7);
+        block1 = _mm_aesenc_si128(block1, k8);
+        block2 = _mm_aesenc_si128(block2, k8);
+        block1 = _mm_aesenc_si128(block1, k9);
+        block2 = _mm_aesenc_si128(block2, k9);
+        block1 = _mm_aesenc_si128(block1, k10);
+        block2 = _mm_aesenc_si128(block2, k10);
+        block1 = _mm_aesenc_si128(block1, k11);
+        block2 = _mm_aesenc_si128(block2, k11);
+        block1 = _mm_aesenc_si128(block1, k12);
+        block2 = _mm_aesenc_si128(block2, k12);
+        block1 = _mm_aesenc_si128(block1, k13);
+        block2 = _mm_aesenc_si128(block2, k13);
+        block1 = _mm_aesenclast_si128(block1, k14);
+        block2 = _mm_aesenclast_si128(block2, k14);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data), block1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 16), block2);
+}
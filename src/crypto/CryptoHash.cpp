@@ -19,8 +19,30 @@
 
 #include <gcrypt.h>
 
+#include <QtConcurrent/QtConcurrentRun>
+
 #include "crypto/Crypto.h"
 
+// batches smaller than this are not worth the thread overhead
+static const int ParallelHashThreshold = 1024 * 1024;
+
+static int gcryptAlgorithm(CryptoHash::Algorithm algo)
+{
+    switch (algo) {
+    case CryptoHash::Sha256:
+        return GCRY_MD_SHA256;
+
+    default:
+        Q_ASSERT(false);
+        return GCRY_MD_NONE;
+    }
+}
+
+static QByteArray hashSha256(const QByteArray& data)
+{
+    return CryptoHash::hash(data, CryptoHash::Sha256);
+}
+
 class CryptoHashPrivate
 {
 public:
@@ -35,17 +57,7 @@ CryptoHash::CryptoHash(CryptoHash::Algorithm algo)
 
     Q_ASSERT(Crypto::initalized());
 
-    int algoGcrypt;
-
-    switch (algo) {
-    case CryptoHash::Sha256:
-        algoGcrypt = GCRY_MD_SHA256;
-        break;
-
-    default:
-        Q_ASSERT(false);
-        break;
-    }
+    int algoGcrypt = gcryptAlgorithm(algo);
 
     gcry_error_t error = gcry_md_open(&d->ctx, algoGcrypt, 0);
     Q_ASSERT(error == 0); // TODO: error handling
@@ -90,8 +102,56 @@ QByteArray CryptoHash::result() const
 
 QByteArray CryptoHash::hash(const QByteArray& data, CryptoHash::Algorithm algo)
 {
-    // replace with gcry_md_hash_buffer()?
-    CryptoHash cryptoHash(algo);
-    cryptoHash.addData(data);
-    return cryptoHash.result();
+    QByteArray result;
+    result.resize(hashSize(algo));
+
+    hash(data.constData(), data.size(), result.data(), algo);
+
+    return result;
+}
+
+void CryptoHash::hash(const char* data, int size, char* result, CryptoHash::Algorithm algo)
+{
+    Q_ASSERT(Crypto::initalized());
+    Q_ASSERT(size >= 0);
+
+    // doesn't need a context and uses the accelerated implementations of libgcrypt
+    gcry_md_hash_buffer(gcryptAlgorithm(algo), result, data, size);
+}
+
+QList<QByteArray> CryptoHash::hashes(const QList<QByteArray>& data, CryptoHash::Algorithm algo)
+{
+    Q_ASSERT(algo == CryptoHash::Sha256);
+
+    qint64 totalSize = 0;
+    Q_FOREACH (const QByteArray& buffer, data) {
+        totalSize += buffer.size();
+    }
+
+    QList<QByteArray> results;
+    results.reserve(data.size());
+
+    if (data.size() > 1 && totalSize >= ParallelHashThreshold) {
+        QList<QFuture<QByteArray> > futures;
+        Q_FOREACH (const QByteArray& buffer, data) {
+            futures.append(QtConcurrent::run(hashSha256, buffer));
+        }
+
+        Q_FOREACH (const QFuture<QByteArray>& future, futures) {
+            results.append(future.result());
+        }
+
+        return results;
+    }
+
+    Q_FOREACH (const QByteArray& buffer, data) {
+        results.append(hash(buffer, algo));
+    }
+
+    return results;
+}
+
+int CryptoHash::hashSize(CryptoHash::Algorithm algo)
+{
+    return gcry_md_get_algo_dlen(gcryptAlgorithm(algo));
 }
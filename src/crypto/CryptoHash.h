@@ -19,6 +19,7 @@
 #define KEEPASSX_CRYPTOHASH_H
 
 #include <QtCore/QByteArray>
+#include <QtCore/QList>
 
 class CryptoHashPrivate;
 
@@ -38,6 +39,18 @@ public:
 
     static QByteArray hash(const QByteArray& data, CryptoHash::Algorithm algo);
 
+    /**
+     * Writes the digest of @p data to @p result which has to hold hashSize(algo) bytes.
+     */
+    static void hash(const char* data, int size, char* result, CryptoHash::Algorithm algo);
+
+    /**
+     * Hashes independent buffers, large batches are spread over several threads.
+     */
+    static QList<QByteArray> hashes(const QList<QByteArray>& data, CryptoHash::Algorithm algo);
+
+    static int hashSize(CryptoHash::Algorithm algo);
+
 private:
     CryptoHashPrivate* const d_ptr;
 
@@ -17,10 +17,72 @@
 
 #include "Random.h"
 
+#include <cstring>
+
 #include <gcrypt.h>
 
+#include <QtCore/QMutex>
+
+#include "core/Tools.h"
 #include "crypto/Crypto.h"
 
+class RandomPool
+{
+public:
+    RandomPool();
+    ~RandomPool();
+
+    void read(char* data, int len);
+
+    static const int Size = 4096;
+
+private:
+    void refill();
+
+    QMutex m_mutex;
+    char m_pool[Size];
+    int m_pos;
+};
+
+RandomPool::RandomPool()
+    : m_pos(Size)
+{
+}
+
+RandomPool::~RandomPool()
+{
+    Tools::wipeMemory(m_pool, Size);
+}
+
+void RandomPool::read(char* data, int len)
+{
+    QMutexLocker locker(&m_mutex);
+
+    while (len > 0) {
+        if (m_pos == Size) {
+            refill();
+        }
+
+        int bytesToCopy = qMin(len, Size - m_pos);
+        memcpy(data, m_pool + m_pos, bytesToCopy);
+        // never hand out the same bytes twice and don't keep them around
+        memset(m_pool + m_pos, 0, bytesToCopy);
+
+        m_pos += bytesToCopy;
+        data += bytesToCopy;
+        len -= bytesToCopy;
+    }
+}
+
+void RandomPool::refill()
+{
+    // every refill is a fresh batch from the libgcrypt RNG which takes care of reseeding itself
+    gcry_randomize(m_pool, Size, GCRY_STRONG_RANDOM);
+    m_pos = 0;
+}
+
+Q_GLOBAL_STATIC(RandomPool, randomPool)
+
 void Random::randomize(QByteArray& ba)
 {
     randomize(ba.data(), ba.size());
@@ -38,11 +100,38 @@ QByteArray Random::randomArray(int len)
 
 quint32 Random::randomUInt(quint32 limit)
 {
+    Q_ASSERT(limit > 0);
+
+    const quint32 threshold = rejectionThreshold(limit);
+
     quint32 rand;
-    randomize(&rand, 4);
+    do {
+        randomize(&rand, 4);
+    } while (rand < threshold);
+
     return (rand % limit);
 }
 
+QVector<quint32> Random::randomUInts(int count, quint32 limit)
+{
+    Q_ASSERT(count >= 0);
+    Q_ASSERT(limit > 0);
+
+    QVector<quint32> values(count);
+    randomize(values.data(), count * static_cast<int>(sizeof(quint32)));
+
+    const quint32 threshold = rejectionThreshold(limit);
+
+    for (int i = 0; i < count; i++) {
+        while (values[i] < threshold) {
+            randomize(&values[i], 4);
+        }
+        values[i] %= limit;
+    }
+
+    return values;
+}
+
 quint32 Random::randomUIntRange(quint32 min, quint32 max)
 {
     return min + randomUInt(max - min);
@@ -52,7 +141,21 @@ void Random::randomize(void* data, int len)
 {
     Q_ASSERT(Crypto::initalized());
 
-    gcry_randomize(data, len, GCRY_STRONG_RANDOM);
+    RandomPool* pool = randomPool();
+
+    // the pool doesn't help for large requests
+    if (len >= RandomPool::Size || !pool) {
+        gcry_randomize(data, len, GCRY_STRONG_RANDOM);
+    }
+    else {
+        pool->read(static_cast<char*>(data), len);
+    }
+}
+
+quint32 Random::rejectionThreshold(quint32 limit)
+{
+    // 2^32 - threshold is a multiple of limit
+    return (0U - limit) % limit;
 }
 
 Random::Random()
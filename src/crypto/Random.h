@@ -19,7 +19,12 @@
 #define KEEPASSX_RANDOM_H
 
 #include <QtCore/QByteArray>
+#include <QtCore/QVector>
 
+/**
+ * Small requests are served from a pool that is filled from the strong
+ * libgcrypt RNG in large batches. Consumed pool bytes are wiped immediately.
+ */
 class Random
 {
 public:
@@ -36,6 +41,17 @@ public:
      */
     static quint32 randomUIntRange(quint32 min, quint32 max);
 
+    /**
+     * Generate @p count random quint32 values in the range [0, @p limit)
+     */
+    static QVector<quint32> randomUInts(int count, quint32 limit);
+
+    /**
+     * Random quint32 values below the returned threshold have to be rejected
+     * when reducing them modulo @p limit, otherwise smaller results are more likely.
+     */
+    static quint32 rejectionThreshold(quint32 limit);
+
 private:
     static void randomize(void* data, int len);
     Random();
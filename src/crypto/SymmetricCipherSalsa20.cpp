@@ -17,8 +17,15 @@
 
 #include "SymmetricCipherSalsa20.h"
 
+#include "config-keepassx.h"
+
+#ifdef HAVE_SSE2
+#include <cpuid.h>
+#endif
+
 SymmetricCipherSalsa20::SymmetricCipherSalsa20(SymmetricCipher::Algorithm algo, SymmetricCipher::Mode mode,
                        SymmetricCipher::Direction direction)
+    : m_useSse2(hasSse2())
 {
     Q_ASSERT(algo == SymmetricCipher::Salsa20);
     Q_UNUSED(algo);
@@ -60,8 +67,7 @@ QByteArray SymmetricCipherSalsa20::process(const QByteArray& data)
     QByteArray result;
     result.resize(data.size());
 
-    ECRYPT_encrypt_bytes(&m_ctx, reinterpret_cast<const u8*>(data.constData()),
-                         reinterpret_cast<u8*>(result.data()), data.size());
+    processBytes(data.constData(), result.data(), data.size());
 
     return result;
 }
@@ -70,8 +76,7 @@ void SymmetricCipherSalsa20::processInPlace(QByteArray& data)
 {
     Q_ASSERT((data.size() < blockSize()) || ((data.size() % blockSize()) == 0));
 
-    ECRYPT_encrypt_bytes(&m_ctx, reinterpret_cast<const u8*>(data.constData()),
-                         reinterpret_cast<u8*>(data.data()), data.size());
+    processBytes(data.constData(), data.data(), data.size());
 }
 
 void SymmetricCipherSalsa20::processInPlace(QByteArray& data, quint64 rounds)
@@ -79,8 +84,7 @@ void SymmetricCipherSalsa20::processInPlace(QByteArray& data, quint64 rounds)
     Q_ASSERT((data.size() < blockSize()) || ((data.size() % blockSize()) == 0));
 
     for (quint64 i = 0; i != rounds; ++i) {
-        ECRYPT_encrypt_bytes(&m_ctx, reinterpret_cast<const u8*>(data.constData()),
-                             reinterpret_cast<u8*>(data.data()), data.size());
+        processBytes(data.constData(), data.data(), data.size());
     }
 }
 
@@ -93,3 +97,54 @@ int SymmetricCipherSalsa20::blockSize() const
 {
     return 64;
 }
+
+void SymmetricCipherSalsa20::setSimdEnabled(bool enabled)
+{
+    m_useSse2 = enabled && hasSse2();
+}
+
+bool SymmetricCipherSalsa20::hasSse2()
+{
+#ifdef HAVE_SSE2
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+
+    return (edx & bit_SSE2) != 0;
+#else
+    return false;
+#endif
+}
+
+void SymmetricCipherSalsa20::setBlockCounter(quint64 counter)
+{
+    m_ctx.input[8] = static_cast<u32>(counter);
+    m_ctx.input[9] = static_cast<u32>(counter >> 32);
+}
+
+void SymmetricCipherSalsa20::processBytes(const char* input, char* output, int size)
+{
+    if (m_useSse2 && size >= 256) {
+        // the kernel processes four blocks at once
+        int bulkSize = size - (size % 256);
+        encryptBlocksSse2(m_ctx.input, input, output, bulkSize / 64);
+
+        input += bulkSize;
+        output += bulkSize;
+        size -= bulkSize;
+    }
+
+    ECRYPT_encrypt_bytes(&m_ctx, reinterpret_cast<const u8*>(input), reinterpret_cast<u8*>(output), size);
+}
+
+#ifndef HAVE_SSE2
+void SymmetricCipherSalsa20::encryptBlocksSse2(quint32* state, const char* in, char* out, int blocks)
+{
+    Q_UNUSED(state);
+    Q_UNUSED(in);
+    Q_UNUSED(out);
+    Q_UNUSED(blocks);
+    Q_ASSERT(false);
+}
+#endif
@@ -42,7 +42,22 @@ public:
     void reset();
     int blockSize() const;
 
+    /**
+     * The SSE2 kernel is used by default if the CPU supports it.
+     * It produces the same output as the reference implementation.
+     */
+    void setSimdEnabled(bool enabled);
+    static bool hasSse2();
+    /**
+     * Sets the 64 bit block counter, only used by the tests.
+     */
+    void setBlockCounter(quint64 counter);
+
 private:
+    void processBytes(const char* input, char* output, int size);
+    static void encryptBlocksSse2(quint32* state, const char* in, char* out, int blocks);
+
+    bool m_useSse2;
     ECRYPT_ctx m_ctx;
     QByteArray m_key;
     QByteArray m_iv;
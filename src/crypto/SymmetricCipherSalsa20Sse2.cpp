@@ -0,0 +1,113 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SymmetricCipherSalsa20.h"
+
+#include <emmintrin.h>
+
+// Only compiled when the compiler supports SSE2 (HAVE_SSE2).
+// The function must not be called unless SymmetricCipherSalsa20::hasSse2() returns true.
+//
+// Every vector holds the same state word of four consecutive blocks.
+
+static inline __m128i rotate(__m128i v, int c)
+{
+    return _mm_or_si128(_mm_slli_epi32(v, c), _mm_srli_epi32(v, 32 - c));
+}
+
+static inline void quarterRound(__m128i& a, __m128i& b, __m128i& c, __m128i& d)
+{
+    b = _mm_xor_si128(b, rotate(_mm_add_epi32(a, d), 7));
+    c = _mm_xor_si128(c, rotate(_mm_add_epi32(b, a), 9));
+    d = _mm_xor_si128(d, rotate(_mm_add_epi32(c, b), 13));
+    a = _mm_xor_si128(a, rotate(_mm_add_epi32(d, c), 18));
+}
+
+void SymmetricCipherSalsa20::encryptBlocksSse2(quint32* state, const char* in, char* out, int blocks)
+{
+    Q_ASSERT(blocks % 4 == 0);
+
+    for (int n = 0; n < blocks; n += 4) {
+        __m128i input[16];
+        for (int i = 0; i < 16; i++) {
+            input[i] = _mm_set1_epi32(static_cast<int>(state[i]));
+        }
+
+        // words 8 and 9 are the 64 bit block counter
+        quint64 counter = state[8] | (static_cast<quint64>(state[9]) << 32);
+        quint32 counterLow[4];
+        quint32 counterHigh[4];
+        for (int i = 0; i < 4; i++) {
+            counterLow[i] = static_cast<quint32>(counter + i);
+            counterHigh[i] = static_cast<quint32>((counter + i) >> 32);
+        }
+        input[8] = _mm_set_epi32(static_cast<int>(counterLow[3]), static_cast<int>(counterLow[2]),
+                                 static_cast<int>(counterLow[1]), static_cast<int>(counterLow[0]));
+        input[9] = _mm_set_epi32(static_cast<int>(counterHigh[3]), static_cast<int>(counterHigh[2]),
+                                 static_cast<int>(counterHigh[1]), static_cast<int>(counterHigh[0]));
+
+        __m128i x[16];
+        for (int i = 0; i < 16; i++) {
+            x[i] = input[i];
+        }
+
+        for (int i = 0; i < 10; i++) {
+            // column round
+            quarterRound(x[0], x[4], x[8], x[12]);
+            quarterRound(x[5], x[9], x[13], x[1]);
+            quarterRound(x[10], x[14], x[2], x[6]);
+            quarterRound(x[15], x[3], x[7], x[11]);
+
+            // row round
+            quarterRound(x[0], x[1], x[2], x[3]);
+            quarterRound(x[5], x[6], x[7], x[4]);
+            quarterRound(x[10], x[11], x[8], x[9]);
+            quarterRound(x[15], x[12], x[13], x[14]);
+        }
+
+        for (int i = 0; i < 16; i++) {
+            x[i] = _mm_add_epi32(x[i], input[i]);
+        }
+
+        // transpose groups of four words so that every vector holds 16 consecutive keystream bytes
+        for (int i = 0; i < 16; i += 4) {
+            __m128i t0 = _mm_unpacklo_epi32(x[i], x[i + 1]);
+            __m128i t1 = _mm_unpacklo_epi32(x[i + 2], x[i + 3]);
+            __m128i t2 = _mm_unpackhi_epi32(x[i], x[i + 1]);
+            __m128i t3 = _mm_unpackhi_epi32(x[i + 2], x[i + 3]);
+
+            __m128i keystream[4];
+            keystream[0] = _mm_unpacklo_epi64(t0, t1);
+            keystream[1] = _mm_unpackhi_epi64(t0, t1);
+            keystream[2] = _mm_unpacklo_epi64(t2, t3);
+            keystream[3] = _mm_unpackhi_epi64(t2, t3);
+
+            for (int block = 0; block < 4; block++) {
+                int offset = block * 64 + i * 4;
+                __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + offset));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + offset), _mm_xor_si128(data, keystream[block]));
+            }
+        }
+
+        counter += 4;
+        state[8] = static_cast<quint32>(counter);
+        state[9] = static_cast<quint32>(counter >> 32);
+
+        in += 256;
+        out += 256;
+    }
+}
@@ -17,7 +17,10 @@
 
 #include "KeePass1Reader.h"
 
+#include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QFile>
+#include <QtCore/QFuture>
+#include <QtCore/QScopedPointer>
 #include <QtCore/QTextCodec>
 #include <QtGui/QImage>
 
@@ -26,6 +29,7 @@
 #include "core/Entry.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
+#include "core/ProgressMonitor.h"
 #include "core/Tools.h"
 #include "crypto/CryptoHash.h"
 #include "format/KeePass1.h"
@@ -286,12 +290,13 @@ SymmetricCipherStream* KeePass1Reader::testKeys(const QString& password, const Q
     QList<PasswordEncoding> encodings;
     encodings << Windows1252 << Latin1 << UTF8;
 
-    QScopedPointer<SymmetricCipherStream> cipherStream;
-    QByteArray passwordData;
+    QList<QByteArray> candidates;
     QTextCodec* codec = QTextCodec::codecForName("Windows-1252");
     QByteArray passwordDataCorrect = codec->fromUnicode(password);
 
     Q_FOREACH (PasswordEncoding encoding, encodings) {
+        QByteArray passwordData;
+
         if (encoding == Windows1252) {
             passwordData = passwordDataCorrect;
         }
@@ -320,7 +325,29 @@ SymmetricCipherStream* KeePass1Reader::testKeys(const QString& password, const Q
             }
         }
 
-        QByteArray finalKey = key(passwordData, keyfileData);
+        candidates.append(passwordData);
+    }
+
+    // Derive the keys of all candidates concurrently. They are verified in the order
+    // of the list and the remaining key derivations are canceled once one matches.
+    ProgressMonitor cancelMonitor;
+    QList<QFuture<QByteArray> > futures;
+    for (int i = 1; i < candidates.size(); i++) {
+        futures.append(QtConcurrent::run(this, &KeePass1Reader::key, candidates[i], keyfileData,
+                                         &cancelMonitor));
+    }
+
+    QScopedPointer<SymmetricCipherStream> cipherStream;
+
+    for (int i = 0; i < candidates.size(); i++) {
+        QByteArray finalKey;
+        if (i == 0) {
+            finalKey = key(candidates[i], keyfileData, &cancelMonitor);
+        }
+        else {
+            finalKey = futures[i - 1].result();
+        }
+
         if (m_encryptionFlags & KeePass1::Rijndael) {
             cipherStream.reset(new SymmetricCipherStream(m_device, SymmetricCipher::Aes256,
                     SymmetricCipher::Cbc, SymmetricCipher::Decrypt, finalKey, m_encryptionIV));
@@ -338,7 +365,8 @@ SymmetricCipherStream* KeePass1Reader::testKeys(const QString& password, const Q
         cipherStream->close();
         if (!m_device->seek(contentPos)) {
             // TODO: error
-            return Q_NULLPTR;
+            cipherStream.reset();
+            break;
         }
         cipherStream->open(QIODevice::ReadOnly);
 
@@ -350,10 +378,17 @@ SymmetricCipherStream* KeePass1Reader::testKeys(const QString& password, const Q
         }
     }
 
+    // the futures reference this object and the monitor
+    cancelMonitor.cancel();
+    for (int i = 0; i < futures.size(); i++) {
+        futures[i].waitForFinished();
+    }
+
     return cipherStream.take();
 }
 
-QByteArray KeePass1Reader::key(const QByteArray& password, const QByteArray& keyfileData)
+QByteArray KeePass1Reader::key(const QByteArray& password, const QByteArray& keyfileData,
+                               ProgressMonitor* monitor)
 {
     Q_ASSERT(!m_masterSeed.isEmpty());
     Q_ASSERT(!m_transformSeed.isEmpty());
@@ -362,9 +397,15 @@ QByteArray KeePass1Reader::key(const QByteArray& password, const QByteArray& key
     key.setPassword(password);
     key.setKeyfileData(keyfileData);
 
+    QByteArray transformedKey = key.transform(m_transformSeed, m_transformRounds, monitor);
+    if (transformedKey.isEmpty()) {
+        // canceled
+        return QByteArray();
+    }
+
     CryptoHash hash(CryptoHash::Sha256);
     hash.addData(m_masterSeed);
-    hash.addData(key.transform(m_transformSeed, m_transformRounds));
+    hash.addData(transformedKey);
     return hash.result();
 }
 
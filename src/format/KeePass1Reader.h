@@ -25,6 +25,7 @@
 class Database;
 class Entry;
 class Group;
+class ProgressMonitor;
 class SymmetricCipherStream;
 class QIODevice;
 
@@ -53,7 +54,8 @@ private:
 
     SymmetricCipherStream* testKeys(const QString& password, const QByteArray& keyfileData,
                                     qint64 contentPos);
-    QByteArray key(const QByteArray& password, const QByteArray& keyfileData);
+    QByteArray key(const QByteArray& password, const QByteArray& keyfileData,
+                   ProgressMonitor* monitor);
     bool verifyKey(SymmetricCipherStream* cipherStream);
     Group* readGroup(QIODevice* cipherStream);
     Entry* readEntry(QIODevice* cipherStream);
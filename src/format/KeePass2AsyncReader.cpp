@@ -0,0 +1,143 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "KeePass2AsyncReader.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QThread>
+
+#include "core/Database.h"
+#include "core/Entry.h"
+#include "core/Group.h"
+#include "core/ProgressMonitor.h"
+#include "format/KeePass2Reader.h"
+
+KeePass2AsyncReader::KeePass2AsyncReader(QObject* parent)
+    : QObject(parent)
+    , m_monitor(Q_NULLPTR)
+    , m_db(Q_NULLPTR)
+    , m_canceled(false)
+    , m_resultPending(false)
+{
+    connect(&m_watcher, SIGNAL(finished()), SLOT(readFinished()));
+}
+
+KeePass2AsyncReader::~KeePass2AsyncReader()
+{
+    // the read may have finished without readFinished() having been called yet
+    if (m_resultPending) {
+        cancel();
+        m_watcher.waitForFinished();
+        delete m_watcher.result();
+    }
+
+    delete m_db;
+}
+
+void KeePass2AsyncReader::readDatabase(const QString& filename, const CompositeKey& key)
+{
+    Q_ASSERT(!isRunning());
+
+    // setFuture() drops the pending finished() notification of the previous read
+    if (m_resultPending) {
+        delete m_watcher.result();
+    }
+
+    delete m_db;
+    m_db = Q_NULLPTR;
+    m_errorString.clear();
+    m_canceled = false;
+    m_resultPending = true;
+
+    // a new monitor for every read as the cancel state can't be reset
+    delete m_monitor;
+    m_monitor = new ProgressMonitor(this);
+    connect(m_monitor, SIGNAL(progressChanged(int)), SIGNAL(progressChanged(int)));
+
+    m_watcher.setFuture(QtConcurrent::run(this, &KeePass2AsyncReader::read, filename, key,
+                                          m_monitor, thread()));
+}
+
+void KeePass2AsyncReader::cancel()
+{
+    if (m_monitor && isRunning()) {
+        m_monitor->cancel();
+    }
+}
+
+bool KeePass2AsyncReader::isRunning() const
+{
+    return m_watcher.isRunning();
+}
+
+bool KeePass2AsyncReader::isCanceled() const
+{
+    return m_canceled;
+}
+
+Database* KeePass2AsyncReader::takeDatabase()
+{
+    Database* db = m_db;
+    m_db = Q_NULLPTR;
+    return db;
+}
+
+QString KeePass2AsyncReader::errorString() const
+{
+    return m_errorString;
+}
+
+void KeePass2AsyncReader::readFinished()
+{
+    m_db = m_watcher.result();
+    m_resultPending = false;
+    m_canceled = m_monitor->isCanceled();
+
+    if (m_canceled) {
+        delete m_db;
+        m_db = Q_NULLPTR;
+    }
+
+    Q_EMIT finished();
+}
+
+Database* KeePass2AsyncReader::read(const QString& filename, const CompositeKey& key,
+                                    ProgressMonitor* monitor, QThread* targetThread)
+{
+    KeePass2Reader reader;
+    reader.setPipelined(QThread::idealThreadCount() > 1);
+    reader.setProgressMonitor(monitor);
+
+    Database* db = reader.readDatabase(filename, key);
+
+    if (db) {
+        // objects can only be pushed to another thread from the thread they live in
+        db->moveToThread(targetThread);
+
+        // history items don't have a parent so they aren't moved with the database
+        Q_FOREACH (Entry* entry, db->rootGroup()->entriesRecursive()) {
+            Q_FOREACH (Entry* historyItem, entry->historyItems()) {
+                historyItem->moveToThread(targetThread);
+            }
+        }
+    }
+    else {
+        m_errorString = reader.errorString();
+    }
+
+    return db;
+}
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_KEEPASS2ASYNCREADER_H
+#define KEEPASSX_KEEPASS2ASYNCREADER_H
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QObject>
+
+#include "core/Global.h"
+#include "keys/CompositeKey.h"
+
+class Database;
+class ProgressMonitor;
+
+/**
+ * Reads a KeePass 2 database in a background thread.
+ *
+ * Emits progressChanged() while the key is transformed and the payload is decoded
+ * and finished() once the database has been read, has failed to read or has been canceled.
+ */
+class KeePass2AsyncReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit KeePass2AsyncReader(QObject* parent = Q_NULLPTR);
+    ~KeePass2AsyncReader();
+
+    void readDatabase(const QString& filename, const CompositeKey& key);
+    void cancel();
+    bool isRunning() const;
+    bool isCanceled() const;
+
+    /**
+     * Returns the database that has been read and transfers the ownership to the caller.
+     */
+    Database* takeDatabase();
+    QString errorString() const;
+
+Q_SIGNALS:
+    void progressChanged(int percent);
+    void finished();
+
+private Q_SLOTS:
+    void readFinished();
+
+private:
+    Database* read(const QString& filename, const CompositeKey& key, ProgressMonitor* monitor,
+                   QThread* targetThread);
+
+    QFutureWatcher<Database*> m_watcher;
+    ProgressMonitor* m_monitor;
+    Database* m_db;
+    QString m_errorString;
+    bool m_canceled;
+    // the future has a result that readFinished() hasn't taken yet
+    bool m_resultPending;
+
+    Q_DISABLE_COPY(KeePass2AsyncReader)
+};
+
+#endif // KEEPASSX_KEEPASS2ASYNCREADER_H
@@ -17,9 +17,14 @@
 
 #include "KeePass2RandomStream.h"
 
+#include <cstring>
+
 #include "crypto/CryptoHash.h"
 #include "format/KeePass2.h"
 
+// generate the key stream in batches of multiple Salsa20 blocks
+const int KeePass2RandomStream::BufferSize = 64 * 64;
+
 KeePass2RandomStream::KeePass2RandomStream(const QByteArray& key)
     : m_cipher(SymmetricCipher::Salsa20, SymmetricCipher::Stream, SymmetricCipher::Encrypt,
           CryptoHash::hash(key, CryptoHash::Sha256), KeePass2::INNER_STREAM_SALSA20_IV)
@@ -30,8 +35,10 @@ KeePass2RandomStream::KeePass2RandomStream(const QByteArray& key)
 QByteArray KeePass2RandomStream::randomBytes(int size)
 {
     QByteArray result;
+    result.resize(size);
 
     int bytesRemaining = size;
+    int offset = 0;
 
     while (bytesRemaining > 0) {
         if (m_buffer.size() == m_offset) {
@@ -39,8 +46,9 @@ QByteArray KeePass2RandomStream::randomBytes(int size)
         }
 
         int bytesToCopy = qMin(bytesRemaining, m_buffer.size() - m_offset);
-        result.append(m_buffer.mid(m_offset, bytesToCopy));
+        memcpy(result.data() + offset, m_buffer.constData() + m_offset, bytesToCopy);
         m_offset += bytesToCopy;
+        offset += bytesToCopy;
         bytesRemaining -= bytesToCopy;
     }
 
@@ -49,23 +57,50 @@ QByteArray KeePass2RandomStream::randomBytes(int size)
 
 QByteArray KeePass2RandomStream::process(const QByteArray& data)
 {
-    QByteArray randomData = randomBytes(data.size());
     QByteArray result;
     result.resize(data.size());
 
-    for (int i = 0; i < data.size(); i++) {
-        result[i] = data[i] ^ randomData[i];
-    }
+    processData(data.constData(), result.data(), data.size());
 
     return result;
 }
 
 void KeePass2RandomStream::processInPlace(QByteArray& data)
 {
-    QByteArray randomData = randomBytes(data.size());
+    processData(data.constData(), data.data(), data.size());
+}
+
+void KeePass2RandomStream::processData(const char* input, char* output, int size)
+{
+    int bytesRemaining = size;
+    int offset = 0;
+
+    while (bytesRemaining > 0) {
+        if (m_buffer.size() == m_offset) {
+            loadBlock();
+        }
+
+        int bytesToProcess = qMin(bytesRemaining, m_buffer.size() - m_offset);
+        const char* keyStream = m_buffer.constData() + m_offset;
+        int i = 0;
+
+        // xor word by word, memcpy keeps this safe for unaligned and overlapping buffers
+        for (; i + 8 <= bytesToProcess; i += 8) {
+            quint64 word;
+            quint64 keyWord;
+            memcpy(&word, input + offset + i, 8);
+            memcpy(&keyWord, keyStream + i, 8);
+            word ^= keyWord;
+            memcpy(output + offset + i, &word, 8);
+        }
+
+        for (; i < bytesToProcess; i++) {
+            output[offset + i] = input[offset + i] ^ keyStream[i];
+        }
 
-    for (int i = 0; i < data.size(); i++) {
-        data[i] = data[i] ^ randomData[i];
+        m_offset += bytesToProcess;
+        offset += bytesToProcess;
+        bytesRemaining -= bytesToProcess;
     }
 }
 
@@ -73,7 +108,7 @@ void KeePass2RandomStream::loadBlock()
 {
     Q_ASSERT(m_offset == m_buffer.size());
 
-    m_buffer.fill('\0', m_cipher.blockSize());
+    m_buffer.fill('\0', BufferSize);
     m_cipher.processInPlace(m_buffer);
     m_offset = 0;
 }
@@ -32,6 +32,9 @@ public:
 
 private:
     void loadBlock();
+    void processData(const char* input, char* output, int size);
+
+    static const int BufferSize;
 
     SymmetricCipher m_cipher;
     QByteArray m_buffer;
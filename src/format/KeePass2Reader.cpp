@@ -23,18 +23,22 @@
 
 #include "core/Database.h"
 #include "core/Endian.h"
+#include "core/ProgressMonitor.h"
 #include "crypto/CryptoHash.h"
 #include "format/KeePass2.h"
 #include "format/KeePass2RandomStream.h"
 #include "format/KeePass2XmlReader.h"
 #include "streams/HashedBlockStream.h"
 #include "streams/QtIOCompressor"
+#include "streams/ReadAheadStream.h"
 #include "streams/StoreDataStream.h"
 #include "streams/SymmetricCipherStream.h"
 
 KeePass2Reader::KeePass2Reader()
 {
     m_saveXml = false;
+    m_pipelined = false;
+    m_progressMonitor = Q_NULLPTR;
 }
 
 Database* KeePass2Reader::readDatabase(QIODevice* device, const CompositeKey& key)
@@ -91,7 +95,14 @@ Database* KeePass2Reader::readDatabase(QIODevice* device, const CompositeKey& ke
         return Q_NULLPTR;
     }
 
-    m_db->setKey(key, m_transformSeed, false);
+    if (m_progressMonitor) {
+        m_progressMonitor->setStage(0, 50);
+    }
+
+    if (!m_db->setKey(key, m_transformSeed, false, m_progressMonitor)) {
+        raiseError(tr("Canceled."));
+        return Q_NULLPTR;
+    }
 
     CryptoHash hash(CryptoHash::Sha256);
     hash.addData(m_masterSeed);
@@ -109,20 +120,55 @@ Database* KeePass2Reader::readDatabase(QIODevice* device, const CompositeKey& ke
         return Q_NULLPTR;
     }
 
-    HashedBlockStream hashedStream(&cipherStream);
+    // in pipelined mode decryption, hash verification, decompression and parsing
+    // each run on their own thread, connected through bounded queues
+    QIODevice* hashedBaseDevice = &cipherStream;
+    QScopedPointer<ReadAheadStream> cipherReadAhead;
+
+    if (m_pipelined) {
+        cipherReadAhead.reset(new ReadAheadStream(&cipherStream, 64 * 1024, 16));
+        cipherReadAhead->open(QIODevice::ReadOnly);
+        hashedBaseDevice = cipherReadAhead.data();
+    }
+
+    HashedBlockStream hashedStream(hashedBaseDevice);
     hashedStream.open(QIODevice::ReadOnly);
 
+    if (m_progressMonitor) {
+        m_progressMonitor->setStage(50, 100);
+        if (!m_device->isSequential()) {
+            hashedStream.setProgressMonitor(m_progressMonitor, m_device->size() - m_device->pos());
+        }
+    }
+
+    QIODevice* hashedDevice = &hashedStream;
+    QScopedPointer<ReadAheadStream> hashedReadAhead;
+
+    if (m_pipelined) {
+        // matches the default block size of HashedBlockStream so every block is verified in place
+        hashedReadAhead.reset(new ReadAheadStream(&hashedStream, 1024 * 1024, 4));
+        hashedReadAhead->open(QIODevice::ReadOnly);
+        hashedDevice = hashedReadAhead.data();
+    }
+
     QIODevice* xmlDevice;
     QScopedPointer<QtIOCompressor> ioCompressor;
+    QScopedPointer<ReadAheadStream> xmlReadAhead;
 
     if (m_db->compressionAlgo() == Database::CompressionNone) {
-        xmlDevice = &hashedStream;
+        xmlDevice = hashedDevice;
     }
     else {
-        ioCompressor.reset(new QtIOCompressor(&hashedStream));
+        ioCompressor.reset(new QtIOCompressor(hashedDevice));
         ioCompressor->setStreamFormat(QtIOCompressor::GzipFormat);
         ioCompressor->open(QIODevice::ReadOnly);
         xmlDevice = ioCompressor.data();
+
+        if (m_pipelined) {
+            xmlReadAhead.reset(new ReadAheadStream(ioCompressor.data(), 64 * 1024, 16));
+            xmlReadAhead->open(QIODevice::ReadOnly);
+            xmlDevice = xmlReadAhead.data();
+        }
     }
 
     KeePass2RandomStream randomStream(m_protectedStreamKey);
@@ -139,6 +185,11 @@ Database* KeePass2Reader::readDatabase(QIODevice* device, const CompositeKey& ke
     KeePass2XmlReader xmlReader;
     xmlReader.readDatabase(xmlDevice, m_db, &randomStream);
 
+    if (isCanceled()) {
+        raiseError(tr("Canceled."));
+        return Q_NULLPTR;
+    }
+
     if (xmlReader.hasError()) {
         raiseError(xmlReader.errorString());
         return Q_NULLPTR;
@@ -154,6 +205,10 @@ Database* KeePass2Reader::readDatabase(QIODevice* device, const CompositeKey& ke
         }
     }
 
+    if (m_progressMonitor) {
+        m_progressMonitor->setStageProgress(1, 1);
+    }
+
     return db.take();
 }
 
@@ -185,6 +240,16 @@ QString KeePass2Reader::errorString()
     return m_errorStr;
 }
 
+void KeePass2Reader::setProgressMonitor(ProgressMonitor* monitor)
+{
+    m_progressMonitor = monitor;
+}
+
+bool KeePass2Reader::isCanceled()
+{
+    return m_progressMonitor && m_progressMonitor->isCanceled();
+}
+
 void KeePass2Reader::setSaveXml(bool save)
 {
     m_saveXml = save;
@@ -195,6 +260,11 @@ QByteArray KeePass2Reader::xmlData()
     return m_xmlData;
 }
 
+void KeePass2Reader::setPipelined(bool pipelined)
+{
+    m_pipelined = pipelined;
+}
+
 void KeePass2Reader::raiseError(const QString& str)
 {
     m_error = true;
@@ -23,6 +23,7 @@
 #include "keys/CompositeKey.h"
 
 class Database;
+class ProgressMonitor;
 class QIODevice;
 
 class KeePass2Reader
@@ -37,6 +38,9 @@ public:
     QString errorString();
     void setSaveXml(bool save);
     QByteArray xmlData();
+    void setPipelined(bool pipelined);
+    void setProgressMonitor(ProgressMonitor* monitor);
+    bool isCanceled();
 
 private:
     void raiseError(const QString& str);
@@ -59,6 +63,8 @@ private:
     QString m_errorStr;
     bool m_headerEnd;
     bool m_saveXml;
+    bool m_pipelined;
+    ProgressMonitor* m_progressMonitor;
     QByteArray m_xmlData;
 
     Database* m_db;
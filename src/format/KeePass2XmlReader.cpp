@@ -20,6 +20,7 @@
 #include <QtCore/QBuffer>
 #include <QtCore/QFile>
 
+#include "core/AttachmentStore.h"
 #include "core/Database.h"
 #include "core/DatabaseIcons.h"
 #include "core/Group.h"
@@ -90,12 +91,31 @@ void KeePass2XmlReader::readDatabase(QIODevice* device, Database* db, KeePass2Ra
         }
     }
 
+    // hash every pool item only once, all references share the stored data
+    QList<QString> poolIds = m_binaryPool.keys();
+    QList<QByteArray> poolData = m_binaryPool.values();
+    QList<QByteArray> poolDataHashes = attachmentStore()->add(poolData);
+    QHash<QString, QByteArray> poolHashes;
+    for (int iPool = 0; iPool < poolIds.size(); iPool++) {
+        poolHashes.insert(poolIds[iPool], poolDataHashes[iPool]);
+    }
+
     QHash<QString, QPair<Entry*, QString> >::const_iterator i;
     for (i = m_binaryMap.constBegin(); i != m_binaryMap.constEnd(); ++i) {
         const QPair<Entry*, QString>& target = i.value();
-        target.first->attachments()->set(target.second, m_binaryPool[i.key()]);
+        if (poolHashes.contains(i.key())) {
+            target.first->attachments()->setHash(target.second, poolHashes.value(i.key()));
+        }
+        else {
+            target.first->attachments()->set(target.second, QByteArray());
+        }
     }
 
+    Q_FOREACH (const QByteArray& hash, poolHashes) {
+        attachmentStore()->release(hash);
+    }
+    m_binaryPool.clear();
+
     m_meta->setUpdateDatetime(true);
 
     QHash<Uuid, Group*>::const_iterator iGroup;
@@ -752,19 +772,26 @@ void KeePass2XmlReader::parseEntryString(Entry* entry)
         }
         else if (m_xml.name() == "Value") {
             QXmlStreamAttributes attr = m_xml.attributes();
-            value = readString();
 
             bool isProtected = attr.value("Protected") == "True";
             bool protectInMemory = attr.value("ProtectInMemory") == "True";
 
-            if (isProtected && !value.isEmpty()) {
-                if (m_randomStream) {
-                    value = QString::fromUtf8(m_randomStream->process(QByteArray::fromBase64(value.toLatin1())));
-                }
-                else {
-                    raiseError(9);
+            if (isProtected) {
+                QByteArray protectedValue = readBinary();
+
+                if (!protectedValue.isEmpty()) {
+                    if (m_randomStream) {
+                        m_randomStream->processInPlace(protectedValue);
+                        value = QString::fromUtf8(protectedValue);
+                    }
+                    else {
+                        raiseError(9);
+                    }
                 }
             }
+            else {
+                value = readString();
+            }
 
             protect = isProtected || protectInMemory;
             valueSet = true;
@@ -1033,7 +1060,76 @@ Uuid KeePass2XmlReader::readUuid()
 
 QByteArray KeePass2XmlReader::readBinary()
 {
-    return QByteArray::fromBase64(readString().toLatin1());
+    Q_ASSERT(m_xml.isStartElement());
+
+    // Decode the base64 text straight from the xml tokens instead of going
+    // through readElementText() and QString::toLatin1().
+    // Invalid characters (including padding) are skipped like QByteArray::fromBase64() does.
+    QByteArray result;
+    quint32 bits = 0;
+    int bitCount = 0;
+    int resultSize = 0;
+
+    while (!m_xml.atEnd()) {
+        QXmlStreamReader::TokenType type = m_xml.readNext();
+
+        if (type == QXmlStreamReader::Characters || type == QXmlStreamReader::EntityReference) {
+            QStringRef text = m_xml.text();
+            const QChar* textData = text.constData();
+            int textSize = text.size();
+
+            int maxSize = resultSize + (textSize * 3) / 4 + 1;
+            if (maxSize > result.capacity()) {
+                result.reserve(qMax(maxSize, result.capacity() * 2));
+            }
+            result.resize(result.capacity());
+            char* resultData = result.data();
+
+            for (int i = 0; i < textSize; i++) {
+                ushort ch = textData[i].unicode();
+                quint32 value;
+
+                if (ch >= 'A' && ch <= 'Z') {
+                    value = ch - 'A';
+                }
+                else if (ch >= 'a' && ch <= 'z') {
+                    value = ch - 'a' + 26;
+                }
+                else if (ch >= '0' && ch <= '9') {
+                    value = ch - '0' + 52;
+                }
+                else if (ch == '+') {
+                    value = 62;
+                }
+                else if (ch == '/') {
+                    value = 63;
+                }
+                else {
+                    continue;
+                }
+
+                bits = (bits << 6) | value;
+                bitCount += 6;
+
+                if (bitCount >= 8) {
+                    bitCount -= 8;
+                    resultData[resultSize++] = static_cast<char>(bits >> bitCount);
+                    bits &= (1 << bitCount) - 1;
+                }
+            }
+
+            result.resize(resultSize);
+        }
+        else if (type == QXmlStreamReader::EndElement) {
+            break;
+        }
+        else if (type == QXmlStreamReader::StartElement) {
+            raiseError(31);
+            break;
+        }
+    }
+
+    return result;
 }
 
 QByteArray KeePass2XmlReader::readCompressedBinary()
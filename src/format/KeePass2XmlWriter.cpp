@@ -19,11 +19,17 @@
 
 #include <QtCore/QBuffer>
 #include <QtCore/QFile>
+#include <QtCore/QThread>
+#include <QtConcurrent/QtConcurrentRun>
 
+#include "core/AttachmentStore.h"
 #include "core/Metadata.h"
 #include "format/KeePass2RandomStream.h"
 #include "streams/QtIOCompressor"
 
+// must be a multiple of 3 so every chunk except the last is encoded without base64 padding
+const int KeePass2XmlWriter::ChunkSize = 48 * 1024;
+
 KeePass2XmlWriter::KeePass2XmlWriter()
     : m_db(Q_NULLPTR)
     , m_meta(Q_NULLPTR)
@@ -43,6 +49,7 @@ void KeePass2XmlWriter::writeDatabase(QIODevice* device, Database* db, KeePass2R
     m_headerHash = headerHash;
 
     generateIdMap();
+    startBinaryCompression();
 
     m_xml.setDevice(device);
 
@@ -71,15 +78,45 @@ void KeePass2XmlWriter::generateIdMap()
     int nextId = 0;
 
     Q_FOREACH (Entry* entry, allEntries) {
-        Q_FOREACH (const QString& key, entry->attachments()->keys()) {
-            QByteArray data = entry->attachments()->value(key);
-            if (!m_idMap.contains(data)) {
-                m_idMap.insert(data, nextId++);
+        Q_FOREACH (const QByteArray& hash, entry->attachments()->hashes()) {
+            if (!m_idMap.contains(hash)) {
+                m_idMap.insert(hash, nextId++);
             }
         }
     }
 }
 
+void KeePass2XmlWriter::startBinaryCompression()
+{
+    m_compressedBinaries.clear();
+    m_nextCompressedBinary = m_idMap.constEnd();
+
+    // A single attachment is compressed while it is written to keep the memory usage low.
+    // With several attachments they are compressed in parallel while the XML preceding
+    // the Binaries element is serialized. Only one attachment per thread is compressed
+    // ahead of writeBinaries() so the compressed copies don't pile up.
+    if (m_db->compressionAlgo() != Database::CompressionGZip || m_idMap.size() < 2) {
+        return;
+    }
+
+    m_nextCompressedBinary = m_idMap.constBegin();
+    int threads = qMax(1, QThread::idealThreadCount());
+    for (int i = 0; i < threads; i++) {
+        startNextBinaryCompression();
+    }
+}
+
+void KeePass2XmlWriter::startNextBinaryCompression()
+{
+    if (m_nextCompressedBinary == m_idMap.constEnd()) {
+        return;
+    }
+
+    QByteArray data = attachmentStore()->data(m_nextCompressedBinary.key());
+    m_compressedBinaries.insert(m_nextCompressedBinary.value(), QtConcurrent::run(compressBinary, data));
+    ++m_nextCompressedBinary;
+}
+
 void KeePass2XmlWriter::writeMetadata()
 {
     m_xml.writeStartElement("Meta");
@@ -168,38 +205,97 @@ void KeePass2XmlWriter::writeBinaries()
 
         m_xml.writeAttribute("ID", QString::number(i.value()));
 
-        QByteArray data;
         if (m_db->compressionAlgo() == Database::CompressionGZip) {
             m_xml.writeAttribute("Compressed", "True");
 
-            QBuffer buffer;
-            buffer.open(QIODevice::ReadWrite);
-
-            QtIOCompressor compressor(&buffer);
-            compressor.setStreamFormat(QtIOCompressor::GzipFormat);
-            compressor.open(QIODevice::WriteOnly);
-
-            qint64 bytesWritten = compressor.write(i.key());
-            Q_ASSERT(bytesWritten == i.key().size());
-            Q_UNUSED(bytesWritten);
-            compressor.close();
-
-            buffer.seek(0);
-            data = buffer.readAll();
+            if (m_compressedBinaries.contains(i.value())) {
+                // binaries are written in the order they have been started
+                QByteArray data = m_compressedBinaries.take(i.value()).result();
+                startNextBinaryCompression();
+                writeBinaryData(data);
+            }
+            else {
+                writeCompressedBinaryData(attachmentStore()->data(i.key()));
+            }
         }
         else {
-            data = i.key();
+            writeBinaryData(attachmentStore()->data(i.key()));
         }
 
-        if (!data.isEmpty()) {
-            m_xml.writeCharacters(QString::fromLatin1(data.toBase64()));
-        }
         m_xml.writeEndElement();
     }
 
     m_xml.writeEndElement();
 }
 
+void KeePass2XmlWriter::writeBinaryData(const QByteArray& data)
+{
+    for (int offset = 0; offset < data.size(); offset += ChunkSize) {
+        writeBase64Characters(data.constData() + offset, qMin(ChunkSize, data.size() - offset));
+    }
+}
+
+void KeePass2XmlWriter::writeCompressedBinaryData(const QByteArray& data)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    QtIOCompressor compressor(&buffer);
+    compressor.setStreamFormat(QtIOCompressor::GzipFormat);
+    compressor.open(QIODevice::WriteOnly);
+
+    for (int offset = 0; offset < data.size(); offset += ChunkSize) {
+        int chunkSize = qMin(ChunkSize, data.size() - offset);
+        qint64 bytesWritten = compressor.write(data.constData() + offset, chunkSize);
+        Q_ASSERT(bytesWritten == chunkSize);
+        Q_UNUSED(bytesWritten);
+
+        writeBase64Buffer(&buffer, false);
+    }
+
+    compressor.close();
+    writeBase64Buffer(&buffer, true);
+}
+
+QByteArray KeePass2XmlWriter::compressBinary(const QByteArray& data)
+{
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+
+    QtIOCompressor compressor(&buffer);
+    compressor.setStreamFormat(QtIOCompressor::GzipFormat);
+    compressor.open(QIODevice::WriteOnly);
+
+    qint64 bytesWritten = compressor.write(data);
+    Q_ASSERT(bytesWritten == data.size());
+    Q_UNUSED(bytesWritten);
+    compressor.close();
+
+    return buffer.data();
+}
+
+void KeePass2XmlWriter::writeBase64Buffer(QBuffer* buffer, bool flush)
+{
+    // drain the compressed output after every chunk so only a chunk of it is held in memory
+    QByteArray& bufferData = buffer->buffer();
+
+    int size = bufferData.size();
+    if (!flush) {
+        size -= size % 3;
+    }
+
+    if (size > 0) {
+        writeBase64Characters(bufferData.constData(), size);
+        bufferData.remove(0, size);
+        buffer->seek(bufferData.size());
+    }
+}
+
+void KeePass2XmlWriter::writeBase64Characters(const char* data, int size)
+{
+    m_xml.writeCharacters(QString::fromLatin1(QByteArray::fromRawData(data, size).toBase64()));
+}
+
 void KeePass2XmlWriter::writeCustomData()
 {
     m_xml.writeStartElement("CustomData");
@@ -366,7 +462,7 @@ void KeePass2XmlWriter::writeEntry(const Entry* entry)
         writeString("Key", key);
 
         m_xml.writeStartElement("Value");
-        m_xml.writeAttribute("Ref", QString::number(m_idMap[entry->attachments()->value(key)]));
+        m_xml.writeAttribute("Ref", QString::number(m_idMap[entry->attachments()->hash(key)]));
         m_xml.writeEndElement();
 
         m_xml.writeEndElement();
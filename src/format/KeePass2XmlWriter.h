@@ -19,6 +19,7 @@
 #define KEEPASSX_KEEPASS2XMLWRITER_H
 
 #include <QtCore/QDateTime>
+#include <QtCore/QFuture>
 #include <QtCore/QXmlStreamWriter>
 #include <QtGui/QColor>
 #include <QtGui/QImage>
@@ -31,6 +32,7 @@
 
 class KeePass2RandomStream;
 class Metadata;
+class QBuffer;
 
 class KeePass2XmlWriter
 {
@@ -44,12 +46,19 @@ public:
 
 private:
     void generateIdMap();
+    void startBinaryCompression();
+    void startNextBinaryCompression();
 
     void writeMetadata();
     void writeMemoryProtection();
     void writeCustomIcons();
     void writeIcon(const Uuid& uuid, const QImage& icon);
     void writeBinaries();
+    void writeBinaryData(const QByteArray& data);
+    void writeCompressedBinaryData(const QByteArray& data);
+    void writeBase64Buffer(QBuffer* buffer, bool flush);
+    void writeBase64Characters(const char* data, int size);
+    static QByteArray compressBinary(const QByteArray& data);
     void writeCustomData();
     void writeCustomDataItem(const QString& key, const QString& value);
     void writeRoot();
@@ -74,12 +83,18 @@ private:
     void writeTriState(const QString& qualifiedName, Group::TriState triState);
     QString colorPartToString(int value);
 
+    static const int ChunkSize;
+
     QXmlStreamWriter m_xml;
     Database* m_db;
     Metadata* m_meta;
     KeePass2RandomStream* m_randomStream;
     QByteArray m_headerHash;
+    // maps attachment hashes to binary pool ids
     QHash<QByteArray, int> m_idMap;
+    QHash<int, QFuture<QByteArray> > m_compressedBinaries;
+    // next entry of m_idMap that is compressed in the background
+    QHash<QByteArray, int>::const_iterator m_nextCompressedBinary;
 };
 
 #endif // KEEPASSX_KEEPASS2XMLWRITER_H
@@ -23,7 +23,7 @@
 #include "core/Config.h"
 #include "core/Database.h"
 #include "gui/FileDialog.h"
-#include "format/KeePass2Reader.h"
+#include "format/KeePass2AsyncReader.h"
 #include "keys/FileKey.h"
 #include "keys/PasswordKey.h"
 
@@ -31,6 +31,7 @@ DatabaseOpenWidget::DatabaseOpenWidget(QWidget* parent)
     : DialogyWidget(parent)
     , m_ui(new Ui::DatabaseOpenWidget())
     , m_db(Q_NULLPTR)
+    , m_reader(new KeePass2AsyncReader(this))
 {
     m_ui->setupUi(this);
 
@@ -53,6 +54,9 @@ DatabaseOpenWidget::DatabaseOpenWidget(QWidget* parent)
 
     connect(m_ui->buttonBox, SIGNAL(accepted()), SLOT(openDatabase()));
     connect(m_ui->buttonBox, SIGNAL(rejected()), SLOT(reject()));
+
+    connect(m_reader, SIGNAL(progressChanged(int)), m_ui->progressBar, SLOT(setValue(int)));
+    connect(m_reader, SIGNAL(finished()), SLOT(readFinished()));
 }
 
 DatabaseOpenWidget::~DatabaseOpenWidget()
@@ -93,34 +97,65 @@ void DatabaseOpenWidget::enterKey(const QString& pw, const QString& keyFile)
 
 void DatabaseOpenWidget::openDatabase()
 {
-    KeePass2Reader reader;
-    CompositeKey masterKey = databaseKey();
-    if (masterKey.isEmpty()) {
+    if (m_reader->isRunning()) {
         return;
     }
 
-    QFile file(m_filename);
-    if (!file.open(QIODevice::ReadOnly)) {
-        // TODO: error message
+    CompositeKey masterKey = databaseKey();
+    if (masterKey.isEmpty()) {
         return;
     }
+
     if (m_db) {
         delete m_db;
+        m_db = Q_NULLPTR;
     }
-    QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-    m_db = reader.readDatabase(&file, masterKey);
-    QApplication::restoreOverrideCursor();
+
+    // key transformation and decoding run in the background so the application stays responsive
+    setReading(true);
+    m_reader->readDatabase(m_filename, masterKey);
+}
+
+void DatabaseOpenWidget::readFinished()
+{
+    setReading(false);
+
+    if (m_reader->isCanceled()) {
+        return;
+    }
+
+    m_db = m_reader->takeDatabase();
 
     if (m_db) {
         Q_EMIT editFinished(true);
     }
     else {
         QMessageBox::warning(this, tr("Error"), tr("Unable to open the database.\n%1")
-                             .arg(reader.errorString()));
+                             .arg(m_reader->errorString()));
         m_ui->editPassword->clear();
     }
 }
 
+void DatabaseOpenWidget::setReading(bool reading)
+{
+    m_ui->progressBar->setValue(0);
+    m_ui->progressBar->setVisible(reading);
+
+    m_ui->checkPassword->setEnabled(!reading);
+    m_ui->editPassword->setEnabled(!reading);
+    m_ui->buttonTogglePassword->setEnabled(!reading);
+    m_ui->checkKeyFile->setEnabled(!reading);
+    m_ui->comboKeyFile->setEnabled(!reading);
+    m_ui->buttonBrowseFile->setEnabled(!reading);
+
+    if (reading) {
+        m_ui->buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
+    }
+    else {
+        setOkButtonEnabled();
+    }
+}
+
 CompositeKey DatabaseOpenWidget::databaseKey()
 {
     CompositeKey masterKey;
@@ -153,6 +188,11 @@ CompositeKey DatabaseOpenWidget::databaseKey()
 
 void DatabaseOpenWidget::reject()
 {
+    if (m_reader->isRunning()) {
+        m_reader->cancel();
+        return;
+    }
+
     Q_EMIT editFinished(false);
 }
 
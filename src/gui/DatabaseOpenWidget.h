@@ -24,6 +24,7 @@
 #include "keys/CompositeKey.h"
 
 class Database;
+class KeePass2AsyncReader;
 class QFile;
 
 namespace Ui {
@@ -52,6 +53,7 @@ protected Q_SLOTS:
     void reject();
 
 private Q_SLOTS:
+    void readFinished();
     void togglePassword(bool checked);
     void activatePassword();
     void activateKeyFile();
@@ -64,6 +66,10 @@ protected:
     QString m_filename;
 
 private:
+    void setReading(bool reading);
+
+    KeePass2AsyncReader* m_reader;
+
     Q_DISABLE_COPY(DatabaseOpenWidget)
 };
 
@@ -30,6 +30,7 @@
 #include "autotype/AutoType.h"
 #include "core/FilePath.h"
 #include "core/Metadata.h"
+#include "core/SearchSession.h"
 #include "core/Tools.h"
 #include "gui/ChangeMasterKeyWidget.h"
 #include "gui/Clipboard.h"
@@ -55,6 +56,7 @@ DatabaseWidget::DatabaseWidget(Database* db, QWidget* parent)
 
     m_searchTimer = new QTimer(this);
     m_searchTimer->setSingleShot(true);
+    m_searchSession = new SearchSession(this);
 
     m_mainWidget = new QWidget(this);
     QLayout* layout = new QHBoxLayout(m_mainWidget);
@@ -569,6 +571,7 @@ void DatabaseWidget::toggleSearch()
 void DatabaseWidget::closeSearch()
 {
     Q_ASSERT(m_lastGroup);
+    m_searchSession->reset();
     m_groupView->setCurrentGroup(m_lastGroup);
 }
 
@@ -632,8 +635,8 @@ void DatabaseWidget::search()
     else {
         sensitivity = Qt::CaseInsensitive;
     }
-    QList<Entry*> searchResult = searchGroup->search(m_searchUi->searchEdit->text(), sensitivity);
-
+    QList<Entry*> searchResult = m_searchSession->search(searchGroup, m_searchUi->searchEdit->text(),
+                                                         sensitivity);
 
     m_entryView->setEntryList(searchResult);
 }
@@ -38,6 +38,7 @@ class GroupView;
 class KeePass1OpenWidget;
 class QFile;
 class QMenu;
+class SearchSession;
 class UnlockDatabaseWidget;
 
 namespace Ui {
@@ -144,6 +145,7 @@ private:
     Group* m_newParent;
     Group* m_lastGroup;
     QTimer* m_searchTimer;
+    SearchSession* m_searchSession;
     QWidget* widgetBeforeLock;
     QString m_filename;
 };
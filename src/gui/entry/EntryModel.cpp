@@ -27,7 +27,11 @@
 EntryModel::EntryModel(QObject* parent)
     : QAbstractTableModel(parent)
     , m_group(Q_NULLPTR)
+    , m_firstStaleRow(0)
+    , m_removedRows(0)
+    , m_scannedRows(0)
 {
+    m_collator.setCaseSensitivity(Qt::CaseInsensitive);
 }
 
 Entry* EntryModel::entryFromIndex(const QModelIndex& index) const
@@ -38,7 +42,7 @@ Entry* EntryModel::entryFromIndex(const QModelIndex& index) const
 
 QModelIndex EntryModel::indexFromEntry(Entry* entry) const
 {
-    int row = m_entries.indexOf(entry);
+    int row = rowFromEntry(entry);
     Q_ASSERT(row != -1);
     return index(row, 1);
 }
@@ -54,8 +58,8 @@ void EntryModel::setGroup(Group* group)
     severConnections();
 
     m_group = group;
-    m_allGroups.clear();
-    m_entries = group->entries();
+    m_databases.clear();
+    setEntries(group->entries());
     m_orgEntries.clear();
 
     makeConnections(group);
@@ -71,23 +75,21 @@ void EntryModel::setEntryList(const QList<Entry*>& entries)
     severConnections();
 
     m_group = Q_NULLPTR;
-    m_allGroups.clear();
-    m_entries = entries;
-    m_orgEntries = entries;
-
-    QSet<Database*> databases;
+    m_databases.clear();
+    setEntries(entries);
+    m_orgEntries = entries.toSet();
 
     Q_FOREACH (Entry* entry, m_entries) {
-        databases.insert(entry->group()->database());
-    }
-
-    Q_FOREACH (Database* db, databases) {
+        const Database* db = entry->group()->database();
         Q_ASSERT(db);
-        m_allGroups.append(db->rootGroup()->groupsRecursive(true));
+        if (!m_databases.contains(db)) {
+            m_databases.append(db);
+        }
     }
 
-    Q_FOREACH (const Group* group, m_allGroups) {
-        makeConnections(group);
+    // the databases forward the entry signals of all their groups
+    Q_FOREACH (const Database* db, m_databases) {
+        makeConnections(db);
     }
 
     endResetModel();
@@ -178,6 +180,19 @@ QVariant EntryModel::headerData(int section, Qt::Orientation orientation, int ro
     return QVariant();
 }
 
+bool EntryModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
+{
+    Q_ASSERT(left.column() == right.column());
+
+    if (left.column() == ParentGroup) {
+        // renaming a group doesn't notify the model so its name can't be cached
+        return m_collator.compare(data(left).toString().toCaseFolded(),
+                                  data(right).toString().toCaseFolded()) < 0;
+    }
+
+    return sortKey(left).compare(sortKey(right)) < 0;
+}
+
 Qt::DropActions EntryModel::supportedDropActions() const
 {
     return Qt::MoveAction | Qt::CopyAction;
@@ -242,10 +257,11 @@ void EntryModel::entryAboutToAdd(Entry* entry)
         return;
     }
 
-    beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size());
-    if (!m_group) {
-        m_entries.append(entry);
-    }
+    // Group::addEntry() appends the entry
+    int row = m_entries.size();
+    beginInsertRows(QModelIndex(), row, row);
+    m_entries.append(entry);
+    m_entryRows.insert(entry, row);
 }
 
 void EntryModel::entryAdded(Entry* entry)
@@ -254,24 +270,30 @@ void EntryModel::entryAdded(Entry* entry)
         return;
     }
 
-    if (m_group) {
-        m_entries = m_group->entries();
-    }
     endInsertRows();
 }
 
 void EntryModel::entryAboutToRemove(Entry* entry)
 {
-    beginRemoveRows(QModelIndex(), m_entries.indexOf(entry), m_entries.indexOf(entry));
-    if (!m_group) {
-        m_entries.removeAll(entry);
+    if (!m_group && !m_orgEntries.contains(entry)) {
+        return;
     }
+
+    int row = rowFromEntry(entry);
+    Q_ASSERT(row != -1);
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_entries.removeAt(row);
+    m_entryRows.remove(entry);
+    clearSortKeys(entry);
+    m_firstStaleRow = qMin(m_firstStaleRow, row);
+    m_removedRows++;
 }
 
-void EntryModel::entryRemoved()
+void EntryModel::entryRemoved(Entry* entry)
 {
-    if (m_group) {
-        m_entries = m_group->entries();
+    if (!m_group && !m_orgEntries.contains(entry)) {
+        return;
     }
 
     endRemoveRows();
@@ -279,7 +301,13 @@ void EntryModel::entryRemoved()
 
 void EntryModel::entryDataChanged(Entry* entry)
 {
-    int row = m_entries.indexOf(entry);
+    int row = rowFromEntry(entry);
+    if (row == -1) {
+        return;
+    }
+
+    clearSortKeys(entry);
+
     Q_EMIT dataChanged(index(row, 0), index(row, columnCount()-1));
 }
 
@@ -289,16 +317,99 @@ void EntryModel::severConnections()
         disconnect(m_group, Q_NULLPTR, this, Q_NULLPTR);
     }
 
-    Q_FOREACH (const Group* group, m_allGroups) {
-        disconnect(group, Q_NULLPTR, this, Q_NULLPTR);
+    Q_FOREACH (const Database* db, m_databases) {
+        disconnect(db, Q_NULLPTR, this, Q_NULLPTR);
+    }
+}
+
+void EntryModel::makeConnections(const QObject* sender)
+{
+    connect(sender, SIGNAL(entryAboutToAdd(Entry*)), SLOT(entryAboutToAdd(Entry*)));
+    connect(sender, SIGNAL(entryAdded(Entry*)), SLOT(entryAdded(Entry*)));
+    connect(sender, SIGNAL(entryAboutToRemove(Entry*)), SLOT(entryAboutToRemove(Entry*)));
+    connect(sender, SIGNAL(entryRemoved(Entry*)), SLOT(entryRemoved(Entry*)));
+    connect(sender, SIGNAL(entryDataChanged(Entry*)), SLOT(entryDataChanged(Entry*)));
+}
+
+void EntryModel::setEntries(const QList<Entry*>& entries)
+{
+    // no lazy fetching, EntryView sorts through a proxy model that only sees fetched rows
+    m_entries = entries;
+    m_entryRows.clear();
+    m_entryRows.reserve(m_entries.size());
+    m_firstStaleRow = 0;
+    m_removedRows = 0;
+    m_scannedRows = 0;
+    m_sortKeys.clear();
+
+    updateStaleRows();
+}
+
+void EntryModel::updateStaleRows() const
+{
+    for (int i = m_firstStaleRow; i < m_entries.size(); i++) {
+        m_entryRows.insert(m_entries.at(i), i);
+    }
+
+    m_firstStaleRow = m_entries.size();
+    m_removedRows = 0;
+    m_scannedRows = 0;
+}
+
+int EntryModel::rowFromEntry(Entry* entry) const
+{
+    QHash<Entry*, int>::iterator it = m_entryRows.find(entry);
+    if (it == m_entryRows.end()) {
+        return -1;
+    }
+
+    int row = it.value();
+    if (row < m_firstStaleRow) {
+        return row;
+    }
+
+    // Removals since the row has been stored only moved the entry up, by one row each.
+    // Removing entries from the top moves it by all of them so that row is checked first.
+    int firstRow = qMax(0, row - m_removedRows);
+    if (m_entries.at(firstRow) == entry) {
+        row = firstRow;
+    }
+    else {
+        row = qMin(row, m_entries.size() - 1);
+        while (m_entries.at(row) != entry) {
+            Q_ASSERT(row > firstRow);
+            row--;
+            m_scannedRows++;
+        }
+    }
+
+    it.value() = row;
+
+    // renumber once the searches have cost as much as that
+    if (m_scannedRows > m_entries.size() - m_firstStaleRow) {
+        updateStaleRows();
     }
+
+    return row;
 }
 
-void EntryModel::makeConnections(const Group* group)
+QCollatorSortKey EntryModel::sortKey(const QModelIndex& index) const
 {
-    connect(group, SIGNAL(entryAboutToAdd(Entry*)), SLOT(entryAboutToAdd(Entry*)));
-    connect(group, SIGNAL(entryAdded(Entry*)), SLOT(entryAdded(Entry*)));
-    connect(group, SIGNAL(entryAboutToRemove(Entry*)), SLOT(entryAboutToRemove(Entry*)));
-    connect(group, SIGNAL(entryRemoved(Entry*)), SLOT(entryRemoved()));
-    connect(group, SIGNAL(entryDataChanged(Entry*)), SLOT(entryDataChanged(Entry*)));
+    QPair<Entry*, int> key(entryFromIndex(index), index.column());
+
+    QHash<QPair<Entry*, int>, QCollatorSortKey>::const_iterator it = m_sortKeys.constFind(key);
+    if (it != m_sortKeys.constEnd()) {
+        return it.value();
+    }
+
+    // QCollator ignores the case sensitivity without ICU in the C locale
+    QString text = data(index).toString().toCaseFolded();
+    return m_sortKeys.insert(key, m_collator.sortKey(text)).value();
+}
+
+void EntryModel::clearSortKeys(Entry* entry)
+{
+    for (int column = 0; column < columnCount(); column++) {
+        m_sortKeys.remove(qMakePair(entry, column));
+    }
 }
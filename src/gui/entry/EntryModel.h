@@ -19,9 +19,14 @@
 #define KEEPASSX_ENTRYMODEL_H
 
 #include <QtCore/QAbstractTableModel>
+#include <QtCore/QCollator>
+#include <QtCore/QHash>
+#include <QtCore/QPair>
+#include <QtCore/QSet>
 
 #include "core/Global.h"
 
+class Database;
 class Entry;
 class Group;
 
@@ -53,6 +58,12 @@ public:
 
     void setEntryList(const QList<Entry*>& entries);
 
+    /**
+     * Locale aware, case insensitive comparison of the displayed text.
+     * The collation keys are cached until the entry changes.
+     */
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const;
+
 Q_SIGNALS:
     void switchedToEntryListMode();
     void switchedToGroupMode();
@@ -64,17 +75,35 @@ private Q_SLOTS:
     void entryAboutToAdd(Entry* entry);
     void entryAdded(Entry* entry);
     void entryAboutToRemove(Entry* entry);
-    void entryRemoved();
+    void entryRemoved(Entry* entry);
     void entryDataChanged(Entry* entry);
 
 private:
     void severConnections();
-    void makeConnections(const Group* group);
+    /**
+     * Connects the entry signals of a Group or a Database.
+     */
+    void makeConnections(const QObject* sender);
+    void setEntries(const QList<Entry*>& entries);
+    void updateStaleRows() const;
+    int rowFromEntry(Entry* entry) const;
+    QCollatorSortKey sortKey(const QModelIndex& index) const;
+    void clearSortKeys(Entry* entry);
 
     Group* m_group;
     QList<Entry*> m_entries;
-    QList<Entry*> m_orgEntries;
-    QList<const Group*> m_allGroups;
+    // row of every entry, the rows from m_firstStaleRow on may be up to m_removedRows
+    // too large and are corrected by rowFromEntry()
+    mutable QHash<Entry*, int> m_entryRows;
+    mutable int m_firstStaleRow;
+    mutable int m_removedRows;
+    // rows compared by rowFromEntry() since the stale rows have been renumbered
+    mutable int m_scannedRows;
+    QSet<Entry*> m_orgEntries;
+    QCollator m_collator;
+    mutable QHash<QPair<Entry*, int>, QCollatorSortKey> m_sortKeys;
+    // databases of the entries in search result mode
+    QList<const Database*> m_databases;
 };
 
 #endif // KEEPASSX_ENTRYMODEL_H
@@ -0,0 +1,43 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_ENTRYSORTMODEL_H
+#define KEEPASSX_ENTRYSORTMODEL_H
+
+#include "gui/SortFilterHideProxyModel.h"
+
+class EntryModel;
+
+/**
+ * Sorts with the cached collation keys of EntryModel instead of collating
+ * the strings on every comparison.
+ */
+class EntrySortModel : public SortFilterHideProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit EntrySortModel(EntryModel* model, QObject* parent = Q_NULLPTR);
+
+protected:
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const Q_DECL_OVERRIDE;
+
+private:
+    EntryModel* const m_model;
+};
+
+#endif // KEEPASSX_ENTRYSORTMODEL_H
@@ -17,18 +17,15 @@
 
 #include "EntryView.h"
 
-#include "gui/SortFilterHideProxyModel.h"
+#include "gui/entry/EntrySortModel.h"
 
 EntryView::EntryView(QWidget* parent)
     : QTreeView(parent)
     , m_model(new EntryModel(this))
-    , m_sortModel(new SortFilterHideProxyModel(this))
+    , m_sortModel(new EntrySortModel(m_model, this))
     , m_inEntryListMode(false)
 {
-    m_sortModel->setSourceModel(m_model);
     m_sortModel->setDynamicSortFilter(true);
-    m_sortModel->setSortLocaleAware(true);
-    m_sortModel->setSortCaseSensitivity(Qt::CaseInsensitive);
     //TODO: In Qt5 is no longer supported. Investigate if is needed at all
     // m_sortModel->setSupportedDragActions(m_model->supportedDragActions());
     QTreeView::setModel(m_sortModel);
@@ -26,8 +26,8 @@
 
 class Entry;
 class EntryModel;
+class EntrySortModel;
 class Group;
-class SortFilterHideProxyModel;
 
 class EntryView : public QTreeView
 {
@@ -57,7 +57,7 @@ private Q_SLOTS:
 
 private:
     EntryModel* const m_model;
-    SortFilterHideProxyModel* const m_sortModel;
+    EntrySortModel* const m_sortModel;
     bool m_inEntryListMode;
 };
 
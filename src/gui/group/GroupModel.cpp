@@ -26,9 +26,12 @@
 #include "core/Metadata.h"
 #include "core/Tools.h"
 
+const int GroupModel::FetchBatchSize = 500;
+
 GroupModel::GroupModel(Database* db, QObject* parent)
     : QAbstractItemModel(parent)
     , m_db(Q_NULLPTR)
+    , m_rowChange(NoRowChange)
 {
     changeDatabase(db);
 }
@@ -42,6 +45,7 @@ void GroupModel::changeDatabase(Database* newDb)
     }
 
     m_db = newDb;
+    m_fetchedChildren.clear();
 
     connect(m_db, SIGNAL(groupDataChanged(Group*)), SLOT(groupDataChanged(Group*)));
     connect(m_db, SIGNAL(groupAboutToAdd(Group*,int)), SLOT(groupAboutToAdd(Group*,int)));
@@ -62,7 +66,7 @@ int GroupModel::rowCount(const QModelIndex& parent) const
     }
     else {
         const Group* group = groupFromIndex(parent);
-        return group->children().size();
+        return fetchedChildCount(group);
     }
 }
 
@@ -162,6 +166,10 @@ QVariant GroupModel::headerData(int section, Qt::Orientation orientation, int ro
 
 QModelIndex GroupModel::index(Group* group) const
 {
+    if (!isFetched(group)) {
+        return QModelIndex();
+    }
+
     int row;
 
     if (!group->parentGroup()) {
@@ -181,6 +189,22 @@ Group* GroupModel::groupFromIndex(const QModelIndex& index) const
     return static_cast<Group*>(index.internalPointer());
 }
 
+void GroupModel::fetchGroup(Group* group)
+{
+    Group* parentGroup = group->parentGroup();
+    if (!parentGroup) {
+        return;
+    }
+
+    fetchGroup(parentGroup);
+
+    QModelIndex parentIndex = index(parentGroup);
+    int row = parentGroup->children().indexOf(group);
+    while (row >= fetchedChildCount(parentGroup)) {
+        fetchMore(parentIndex);
+    }
+}
+
 Qt::DropActions GroupModel::supportedDropActions() const
 {
     return Qt::MoveAction | Qt::CopyAction;
@@ -362,9 +386,56 @@ QMimeData* GroupModel::mimeData(const QModelIndexList& indexes) const
     }
 }
 
+bool GroupModel::canFetchMore(const QModelIndex& parent) const
+{
+    if (!parent.isValid()) {
+        return false;
+    }
+
+    const Group* group = groupFromIndex(parent);
+    return fetchedChildCount(group) < group->children().size();
+}
+
+void GroupModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    const Group* group = groupFromIndex(parent);
+    int first = fetchedChildCount(group);
+    int last = qMin(first + FetchBatchSize, group->children().size()) - 1;
+
+    beginInsertRows(parent, first, last);
+    m_fetchedChildren.insert(group, last + 1);
+    endInsertRows();
+}
+
+int GroupModel::fetchedChildCount(const Group* group) const
+{
+    return qMin(m_fetchedChildren.value(group, FetchBatchSize), group->children().size());
+}
+
+bool GroupModel::isFetched(const Group* group) const
+{
+    const Group* parentGroup = group->parentGroup();
+
+    if (!parentGroup) {
+        return true;
+    }
+    else {
+        return parentGroup->children().indexOf(const_cast<Group*>(group)) < fetchedChildCount(parentGroup)
+                && isFetched(parentGroup);
+    }
+}
+
 void GroupModel::groupDataChanged(Group* group)
 {
     QModelIndex ix = index(group);
+    if (!ix.isValid()) {
+        return;
+    }
+
     Q_EMIT dataChanged(ix, ix);
 }
 
@@ -372,52 +443,123 @@ void GroupModel::groupAboutToRemove(Group* group)
 {
     Q_ASSERT(group->parentGroup());
 
+    m_fetchedChildren.remove(group);
+
+    if (!isFetched(group)) {
+        m_rowChange = NoRowChange;
+        return;
+    }
+
     QModelIndex parentIndex = parent(group);
     Q_ASSERT(parentIndex.isValid());
-    int pos = group->parentGroup()->children().indexOf(group);
+    Group* parentGroup = group->parentGroup();
+    int pos = parentGroup->children().indexOf(group);
     Q_ASSERT(pos != -1);
 
+    m_rowChange = RowRemove;
     beginRemoveRows(parentIndex, pos, pos);
+    m_fetchedChildren.insert(parentGroup, fetchedChildCount(parentGroup) - 1);
 }
 
 void GroupModel::groupRemoved()
 {
-    endRemoveRows();
+    if (m_rowChange == RowRemove) {
+        endRemoveRows();
+    }
 }
 
 void GroupModel::groupAboutToAdd(Group* group, int index)
 {
     Q_ASSERT(group->parentGroup());
 
+    // a group inserted after the fetched children doesn't get a row
+    Group* parentGroup = group->parentGroup();
+    if (!isFetched(parentGroup) || index > fetchedChildCount(parentGroup)) {
+        m_rowChange = NoRowChange;
+        return;
+    }
+
     QModelIndex parentIndex = parent(group);
 
+    m_rowChange = RowInsert;
     beginInsertRows(parentIndex, index, index);
+    m_fetchedChildren.insert(parentGroup, fetchedChildCount(parentGroup) + 1);
 }
 
 void GroupModel::groupAdded()
 {
-    endInsertRows();
+    if (m_rowChange == RowInsert) {
+        endInsertRows();
+    }
 }
 
 void GroupModel::groupAboutToMove(Group* group, Group* toGroup, int pos)
 {
     Q_ASSERT(group->parentGroup());
 
+    Group* oldParentGroup = group->parentGroup();
+    int oldFetched = fetchedChildCount(oldParentGroup);
+    int newFetched = fetchedChildCount(toGroup);
+    bool oldRow = isFetched(group);
+    bool newRow = isFetched(toGroup);
+
+    // pos is the position after the group has been removed from its old parent
+    if (oldRow && oldParentGroup == toGroup) {
+        newRow = newRow && pos < newFetched;
+    }
+    else {
+        newRow = newRow && pos <= newFetched;
+    }
+
     QModelIndex oldParentIndex = parent(group);
     QModelIndex newParentIndex = index(toGroup);
-    int oldPos = group->parentGroup()->children().indexOf(group);
-    if (group->parentGroup() == toGroup && pos > oldPos) {
-        // beginMoveRows() has a bit different semantics than Group::setParent() and
-        // QList::move() when the new position is greater than the old
-        pos++;
-    }
+    int oldPos = oldParentGroup->children().indexOf(group);
+
+    if (oldRow && newRow) {
+        if (oldParentGroup == toGroup && pos > oldPos) {
+            // beginMoveRows() has a bit different semantics than Group::setParent() and
+            // QList::move() when the new position is greater than the old
+            pos++;
+        }
 
-    bool moveResult = beginMoveRows(oldParentIndex, oldPos, oldPos, newParentIndex, pos);
-    Q_UNUSED(moveResult);
-    Q_ASSERT(moveResult);
+        m_rowChange = RowMove;
+        bool moveResult = beginMoveRows(oldParentIndex, oldPos, oldPos, newParentIndex, pos);
+        Q_UNUSED(moveResult);
+        Q_ASSERT(moveResult);
+
+        if (oldParentGroup != toGroup) {
+            m_fetchedChildren.insert(oldParentGroup, oldFetched - 1);
+            m_fetchedChildren.insert(toGroup, newFetched + 1);
+        }
+    }
+    else if (oldRow) {
+        m_rowChange = RowRemove;
+        beginRemoveRows(oldParentIndex, oldPos, oldPos);
+        m_fetchedChildren.insert(oldParentGroup, oldFetched - 1);
+    }
+    else if (newRow) {
+        m_rowChange = RowInsert;
+        beginInsertRows(newParentIndex, pos, pos);
+        m_fetchedChildren.insert(toGroup, newFetched + 1);
+    }
+    else {
+        m_rowChange = NoRowChange;
+    }
 }
 
 void GroupModel::groupMoved()
 {
-    endMoveRows();
+    switch (m_rowChange) {
+    case RowMove:
+        endMoveRows();
+        break;
+    case RowRemove:
+        endRemoveRows();
+        break;
+    case RowInsert:
+        endInsertRows();
+        break;
+    default:
+        break;
+    }
 }
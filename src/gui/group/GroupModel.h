@@ -19,6 +19,7 @@
 #define KEEPASSX_GROUPMODEL_H
 
 #include <QtCore/QAbstractItemModel>
+#include <QtCore/QHash>
 
 #include "core/Global.h"
 
@@ -32,8 +33,15 @@ class GroupModel : public QAbstractItemModel
 public:
     explicit GroupModel(Database* db, QObject* parent = Q_NULLPTR);
     void changeDatabase(Database* newDb);
+    /**
+     * Returns an invalid index if the group hasn't been fetched yet.
+     */
     QModelIndex index(Group* group) const;
     Group* groupFromIndex(const QModelIndex& index) const;
+    /**
+     * Fetches the group and all its parents if necessary.
+     */
+    void fetchGroup(Group* group);
 
     int rowCount(const QModelIndex& parent = QModelIndex()) const;
     int columnCount(const QModelIndex& parent = QModelIndex()) const;
@@ -47,9 +55,26 @@ public:
                       const QModelIndex& parent) Q_DECL_OVERRIDE;
     QStringList mimeTypes() const Q_DECL_OVERRIDE;
     QMimeData* mimeData(const QModelIndexList& indexes) const Q_DECL_OVERRIDE;
+    bool canFetchMore(const QModelIndex& parent) const Q_DECL_OVERRIDE;
+    void fetchMore(const QModelIndex& parent) Q_DECL_OVERRIDE;
+
+    /**
+     * Number of child groups that are added to the model at once.
+     */
+    static const int FetchBatchSize;
 
 private:
+    enum RowChange
+    {
+        NoRowChange,
+        RowInsert,
+        RowRemove,
+        RowMove
+    };
+
     QModelIndex parent(Group* group) const;
+    int fetchedChildCount(const Group* group) const;
+    bool isFetched(const Group* group) const;
 
 private Q_SLOTS:
     void groupDataChanged(Group* group);
@@ -62,6 +87,10 @@ private Q_SLOTS:
 
 private:
     Database* m_db;
+    // number of children that have rows, FetchBatchSize if a group isn't listed
+    QHash<const Group*, int> m_fetchedChildren;
+    // how the group that is being added, removed or moved changes the rows
+    RowChange m_rowChange;
 };
 
 #endif // KEEPASSX_GROUPMODEL_H
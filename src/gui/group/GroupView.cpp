@@ -21,6 +21,7 @@
 #include <QtCore/QMimeData>
 #include <QtGui/QDragMoveEvent>
 
+#include "core/Config.h"
 #include "core/Database.h"
 #include "core/Group.h"
 #include "gui/group/GroupModel.h"
@@ -88,8 +89,9 @@ void GroupView::expandedChanged(const QModelIndex& index)
         return;
     }
 
+    // Group doesn't read the config itself since readers may run in a worker thread
     Group* group = m_model->groupFromIndex(index);
-    group->setExpanded(isExpanded(index));
+    group->setExpanded(isExpanded(index), config()->get("ModifiedOnExpandedStateChanges").toBool());
 }
 
 void GroupView::recInitExpanded(Group* group)
@@ -98,8 +100,10 @@ void GroupView::recInitExpanded(Group* group)
     expandGroup(group, group->isExpanded());
     m_updatingExpanded = false;
 
-    Q_FOREACH (Group* child, group->children()) {
-        recInitExpanded(child);
+    // children that haven't been fetched are handled by syncExpandedState()
+    QModelIndex index = m_model->index(group);
+    for (int row = 0; row < m_model->rowCount(index); row++) {
+        recInitExpanded(m_model->groupFromIndex(m_model->index(row, 0, index)));
     }
 }
 
@@ -135,6 +139,7 @@ void GroupView::syncExpandedState(const QModelIndex& parent, int start, int end)
 
 void GroupView::setCurrentGroup(Group* group)
 {
+    m_model->fetchGroup(group);
     setCurrentIndex(m_model->index(group));
 }
 
@@ -21,8 +21,12 @@
 #include <QtConcurrent/QtConcurrentRun>
 #include <QtCore/QTime>
 
+#include "core/ProgressMonitor.h"
+#include "crypto/AesKeyTransform.h"
 #include "crypto/CryptoHash.h"
-#include "crypto/SymmetricCipher.h"
+
+// check for cancellation and report progress after this many rounds
+const quint64 CompositeKey::ProgressRounds = 100000;
 
 CompositeKey::CompositeKey()
 {
@@ -81,33 +85,68 @@ QByteArray CompositeKey::rawKey() const
     return cryptoHash.result();
 }
 
-QByteArray CompositeKey::transform(const QByteArray& seed, quint64 rounds) const
+/**
+ * Returns an empty QByteArray if the transformation has been canceled through the monitor.
+ */
+QByteArray CompositeKey::transform(const QByteArray& seed, quint64 rounds,
+                                   ProgressMonitor* monitor) const
 {
     Q_ASSERT(seed.size() == 32);
     Q_ASSERT(rounds > 0);
 
     QByteArray key = rawKey();
+    QByteArray transformed;
 
-    QFuture<QByteArray> future = QtConcurrent::run(transformKeyRaw, key.left(16), seed, rounds);
-    QByteArray result2 = transformKeyRaw(key.right(16), seed, rounds);
+    if (AesKeyTransform::hasAesNi()) {
+        // the AES-NI kernel interleaves both halves on one core
+        transformed = transformKeyRaw(key, seed, rounds, monitor, true);
+    }
+    else {
+        // both halves take the same time so only one of them reports the progress
+        QFuture<QByteArray> future = QtConcurrent::run(transformKeyRaw, key.left(16), seed, rounds,
+                                                       monitor, false);
+        QByteArray result2 = transformKeyRaw(key.right(16), seed, rounds, monitor, true);
+        QByteArray result1 = future.result();
+
+        transformed.append(result1);
+        transformed.append(result2);
+    }
 
-    QByteArray transformed;
-    transformed.append(future.result());
-    transformed.append(result2);
+    if (monitor && monitor->isCanceled()) {
+        return QByteArray();
+    }
 
     return CryptoHash::hash(transformed, CryptoHash::Sha256);
 }
 
 QByteArray CompositeKey::transformKeyRaw(const QByteArray& key, const QByteArray& seed,
-                                         quint64 rounds)
+                                         quint64 rounds, ProgressMonitor* monitor,
+                                         bool reportProgress)
 {
-    QByteArray iv(16, 0);
-    SymmetricCipher cipher(SymmetricCipher::Aes256, SymmetricCipher::Ecb,
-                           SymmetricCipher::Encrypt, seed, iv);
+    AesKeyTransform transform(seed);
 
     QByteArray result = key;
 
-    cipher.processInPlace(result, rounds);
+    if (!monitor) {
+        transform.transform(result, rounds);
+        return result;
+    }
+
+    quint64 roundsDone = 0;
+
+    while (roundsDone < rounds) {
+        if (monitor->isCanceled()) {
+            return QByteArray();
+        }
+
+        quint64 roundsToDo = qMin(ProgressRounds, rounds - roundsDone);
+        transform.transform(result, roundsToDo);
+        roundsDone += roundsToDo;
+
+        if (reportProgress) {
+            monitor->setStageProgress(static_cast<qint64>(roundsDone), static_cast<qint64>(rounds));
+        }
+    }
 
     return result;
 }
@@ -119,8 +158,17 @@ void CompositeKey::addKey(const Key& key)
 
 int CompositeKey::transformKeyBenchmark(int msec)
 {
-    TransformKeyBenchmarkThread thread1(msec);
-    TransformKeyBenchmarkThread thread2(msec);
+    if (AesKeyTransform::hasAesNi()) {
+        // mirror transform() which does both halves in one thread
+        TransformKeyBenchmarkThread thread(msec, 32);
+        thread.start();
+        thread.wait();
+
+        return thread.rounds();
+    }
+
+    TransformKeyBenchmarkThread thread1(msec, 16);
+    TransformKeyBenchmarkThread thread2(msec, 16);
 
     thread1.start();
     thread2.start();
@@ -132,8 +180,9 @@ int CompositeKey::transformKeyBenchmark(int msec)
 }
 
 
-TransformKeyBenchmarkThread::TransformKeyBenchmarkThread(int msec)
+TransformKeyBenchmarkThread::TransformKeyBenchmarkThread(int msec, int keySize)
     : m_msec(msec)
+    , m_keySize(keySize)
     , m_rounds(0)
 {
     Q_ASSERT(msec > 0);
@@ -146,18 +195,16 @@ int TransformKeyBenchmarkThread::rounds()
 
 void TransformKeyBenchmarkThread::run()
 {
-    QByteArray key = QByteArray(16, '\x7E');
+    QByteArray key = QByteArray(m_keySize, '\x7E');
     QByteArray seed = QByteArray(32, '\x4B');
-    QByteArray iv(16, 0);
 
-    SymmetricCipher cipher(SymmetricCipher::Aes256, SymmetricCipher::Ecb,
-                           SymmetricCipher::Encrypt, seed, iv);
+    AesKeyTransform transform(seed);
 
     QTime t;
     t.start();
 
     do {
-        cipher.processInPlace(key, 100);
+        transform.transform(key, 100);
         m_rounds += 100;
     } while (t.elapsed() < m_msec);
 }
@@ -22,6 +22,8 @@
 
 #include "keys/Key.h"
 
+class ProgressMonitor;
+
 class CompositeKey : public Key
 {
 public:
@@ -34,14 +36,17 @@ public:
     CompositeKey& operator=(const CompositeKey& key);
 
     QByteArray rawKey() const;
-    QByteArray transform(const QByteArray& seed, quint64 rounds) const;
+    QByteArray transform(const QByteArray& seed, quint64 rounds,
+                         ProgressMonitor* monitor = Q_NULLPTR) const;
     void addKey(const Key& key);
 
     static int transformKeyBenchmark(int msec);
 
 private:
     static QByteArray transformKeyRaw(const QByteArray& key, const QByteArray& seed,
-                                      quint64 rounds);
+                                      quint64 rounds, ProgressMonitor* monitor, bool reportProgress);
+
+    static const quint64 ProgressRounds;
 
     QList<Key*> m_keys;
 };
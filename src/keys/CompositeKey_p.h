@@ -25,7 +25,7 @@ class TransformKeyBenchmarkThread : public QThread
     Q_OBJECT
 
 public:
-    explicit TransformKeyBenchmarkThread(int msec);
+    TransformKeyBenchmarkThread(int msec, int keySize);
     int rounds();
 
 protected:
@@ -33,6 +33,7 @@ protected:
 
 private:
     int m_msec;
+    int m_keySize;
     int m_rounds;
 };
 
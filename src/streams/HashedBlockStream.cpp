@@ -20,6 +20,7 @@
 #include <cstring>
 
 #include "core/Endian.h"
+#include "core/ProgressMonitor.h"
 #include "crypto/CryptoHash.h"
 
 const QSysInfo::Endian HashedBlockStream::ByteOrder = QSysInfo::LittleEndian;
@@ -27,6 +28,8 @@ const QSysInfo::Endian HashedBlockStream::ByteOrder = QSysInfo::LittleEndian;
 HashedBlockStream::HashedBlockStream(QIODevice* baseDevice)
     : LayeredStream(baseDevice)
     , m_blockSize(1024*1024)
+    , m_progressMonitor(Q_NULLPTR)
+    , m_expectedSize(0)
 {
     init();
 }
@@ -34,6 +37,8 @@ HashedBlockStream::HashedBlockStream(QIODevice* baseDevice)
 HashedBlockStream::HashedBlockStream(QIODevice* baseDevice, qint32 blockSize)
     : LayeredStream(baseDevice)
     , m_blockSize(blockSize)
+    , m_progressMonitor(Q_NULLPTR)
+    , m_expectedSize(0)
 {
     init();
 }
@@ -50,6 +55,7 @@ void HashedBlockStream::init()
     m_blockIndex = 0;
     m_eof = false;
     m_error = false;
+    m_bytesVerified = 0;
 }
 
 bool HashedBlockStream::reset()
@@ -72,6 +78,12 @@ bool HashedBlockStream::reset()
     return true;
 }
 
+void HashedBlockStream::setProgressMonitor(ProgressMonitor* monitor, qint64 expectedSize)
+{
+    m_progressMonitor = monitor;
+    m_expectedSize = expectedSize;
+}
+
 void HashedBlockStream::close()
 {
     if (isWritable()) {
@@ -100,7 +112,7 @@ qint64 HashedBlockStream::readData(char* data, qint64 maxSize)
 
     while (bytesRemaining > 0) {
         if (m_bufferPos == m_buffer.size()) {
-            if (!readHashedBlock()) {
+            if (!readHashedBlockHeader()) {
                 if (m_error) {
                     return -1;
                 }
@@ -108,6 +120,23 @@ qint64 HashedBlockStream::readData(char* data, qint64 maxSize)
                     return maxSize - bytesRemaining;
                 }
             }
+
+            if (bytesRemaining >= m_blockSize) {
+                // the whole block fits: read and verify it directly in the caller's buffer
+                if (!readHashedBlockData(data + offset)) {
+                    return -1;
+                }
+
+                offset += m_blockSize;
+                bytesRemaining -= m_blockSize;
+                continue;
+            }
+
+            m_buffer.resize(m_blockSize);
+            if (!readHashedBlockData(m_buffer.data())) {
+                return -1;
+            }
+            m_bufferPos = 0;
         }
 
         int bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(m_buffer.size() - m_bufferPos));
@@ -122,8 +151,14 @@ qint64 HashedBlockStream::readData(char* data, qint64 maxSize)
     return maxSize;
 }
 
-bool HashedBlockStream::readHashedBlock()
+bool HashedBlockStream::readHashedBlockHeader()
 {
+    if (m_progressMonitor && m_progressMonitor->isCanceled()) {
+        setErrorString("Operation canceled.");
+        m_error = true;
+        return false;
+    }
+
     bool ok;
 
     quint32 index = Endian::readUInt32(m_baseDevice, ByteOrder, &ok);
@@ -132,8 +167,8 @@ bool HashedBlockStream::readHashedBlock()
         return false;
     }
 
-    QByteArray hash = m_baseDevice->read(32);
-    if (hash.size() != 32) {
+    m_blockHash.resize(32);
+    if (m_baseDevice->read(m_blockHash.data(), 32) != 32) {
         m_error = true;
         return false;
     }
@@ -145,7 +180,7 @@ bool HashedBlockStream::readHashedBlock()
     }
 
     if (m_blockSize == 0) {
-        if (hash.count('\0') != 32) {
+        if (m_blockHash.count('\0') != 32) {
             m_error = true;
             return false;
         }
@@ -154,20 +189,30 @@ bool HashedBlockStream::readHashedBlock()
         return false;
     }
 
-    m_buffer = m_baseDevice->read(m_blockSize);
-    if (m_buffer.size() != m_blockSize) {
+    return true;
+}
+
+bool HashedBlockStream::readHashedBlockData(char* data)
+{
+    if (m_baseDevice->read(data, m_blockSize) != m_blockSize) {
         m_error = true;
         return false;
     }
 
-    if (hash != CryptoHash::hash(m_buffer, CryptoHash::Sha256)) {
+    char hash[32];
+    CryptoHash::hash(data, m_blockSize, hash, CryptoHash::Sha256);
+    if (QByteArray::fromRawData(hash, sizeof(hash)) != m_blockHash) {
         m_error = true;
         return false;
     }
 
-    m_bufferPos = 0;
     m_blockIndex++;
 
+    if (m_progressMonitor) {
+        m_bytesVerified += m_blockSize;
+        m_progressMonitor->setStageProgress(m_bytesVerified, m_expectedSize);
+    }
+
     return true;
 }
 
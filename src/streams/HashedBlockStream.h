@@ -22,6 +22,8 @@
 
 #include "streams/LayeredStream.h"
 
+class ProgressMonitor;
+
 class HashedBlockStream : public LayeredStream
 {
     Q_OBJECT
@@ -34,22 +36,33 @@ public:
     bool reset();
     void close();
 
+    /**
+     * Reports the number of verified bytes relative to expectedSize while reading
+     * and fails with an error once the monitor has been canceled.
+     */
+    void setProgressMonitor(ProgressMonitor* monitor, qint64 expectedSize);
+
 protected:
     qint64 readData(char* data, qint64 maxSize) Q_DECL_OVERRIDE;
     qint64 writeData(const char* data, qint64 maxSize) Q_DECL_OVERRIDE;
 
 private:
     void init();
-    bool readHashedBlock();
+    bool readHashedBlockHeader();
+    bool readHashedBlockData(char* data);
     bool writeHashedBlock();
 
     static const QSysInfo::Endian ByteOrder;
     qint32 m_blockSize;
+    QByteArray m_blockHash;
     QByteArray m_buffer;
     int m_bufferPos;
     quint32 m_blockIndex;
     bool m_eof;
     bool m_error;
+    ProgressMonitor* m_progressMonitor;
+    qint64 m_expectedSize;
+    qint64 m_bytesVerified;
 };
 
 #endif // KEEPASSX_HASHEDBLOCKSTREAM_H
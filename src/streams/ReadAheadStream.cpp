@@ -0,0 +1,195 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ReadAheadStream.h"
+#include "ReadAheadStream_p.h"
+
+#include <cstring>
+
+ReadAheadStream::ReadAheadStream(QIODevice* baseDevice, int blockSize, int maxBlocks)
+    : LayeredStream(baseDevice)
+    , m_blockSize(blockSize)
+    , m_maxBlocks(maxBlocks)
+    , m_thread(Q_NULLPTR)
+    , m_baseEof(false)
+    , m_baseError(false)
+    , m_stop(false)
+    , m_bufferPos(0)
+{
+    Q_ASSERT(blockSize > 0);
+    Q_ASSERT(maxBlocks > 0);
+}
+
+ReadAheadStream::~ReadAheadStream()
+{
+    close();
+}
+
+bool ReadAheadStream::open(QIODevice::OpenMode mode)
+{
+    if (mode & QIODevice::WriteOnly) {
+        qWarning("ReadAheadStream::open: Writing is not supported.");
+        return false;
+    }
+
+    if (!LayeredStream::open(mode)) {
+        return false;
+    }
+
+    m_queue.clear();
+    m_baseEof = false;
+    m_baseError = false;
+    m_baseErrorString.clear();
+    m_stop = false;
+    m_buffer.clear();
+    m_bufferPos = 0;
+
+    m_thread = new ReadAheadThread(this);
+    m_thread->start();
+
+    return true;
+}
+
+void ReadAheadStream::close()
+{
+    stopThread();
+
+    LayeredStream::close();
+}
+
+QString ReadAheadStream::errorString() const
+{
+    if (!m_baseErrorString.isEmpty()) {
+        return m_baseErrorString;
+    }
+    else {
+        return LayeredStream::errorString();
+    }
+}
+
+void ReadAheadStream::stopThread()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    m_mutex.lock();
+    m_stop = true;
+    m_spaceAvailable.wakeAll();
+    m_blockAvailable.wakeAll();
+    m_mutex.unlock();
+
+    m_thread->wait();
+    delete m_thread;
+    m_thread = Q_NULLPTR;
+
+    m_queue.clear();
+}
+
+qint64 ReadAheadStream::readData(char* data, qint64 maxSize)
+{
+    qint64 bytesRemaining = maxSize;
+    qint64 offset = 0;
+
+    while (bytesRemaining > 0) {
+        if (m_bufferPos == m_buffer.size()) {
+            QMutexLocker locker(&m_mutex);
+
+            while (m_queue.isEmpty() && !m_baseEof && !m_baseError && !m_stop) {
+                m_blockAvailable.wait(&m_mutex);
+            }
+
+            if (m_queue.isEmpty()) {
+                if (m_baseError && offset == 0) {
+                    return -1;
+                }
+                else {
+                    return maxSize - bytesRemaining;
+                }
+            }
+
+            m_buffer = m_queue.dequeue();
+            m_bufferPos = 0;
+            m_spaceAvailable.wakeOne();
+        }
+
+        int bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(m_buffer.size() - m_bufferPos));
+
+        memcpy(data + offset, m_buffer.constData() + m_bufferPos, bytesToCopy);
+
+        offset += bytesToCopy;
+        m_bufferPos += bytesToCopy;
+        bytesRemaining -= bytesToCopy;
+    }
+
+    return maxSize;
+}
+
+qint64 ReadAheadStream::writeData(const char* data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+
+    return -1;
+}
+
+void ReadAheadStream::readAhead()
+{
+    QMutexLocker locker(&m_mutex);
+
+    while (!m_stop) {
+        locker.unlock();
+
+        QByteArray block;
+        block.resize(m_blockSize);
+        qint64 bytesRead = m_baseDevice->read(block.data(), m_blockSize);
+
+        locker.relock();
+
+        if (bytesRead < 0) {
+            m_baseError = true;
+            m_baseErrorString = m_baseDevice->errorString();
+            m_blockAvailable.wakeAll();
+            return;
+        }
+        else if (bytesRead == 0) {
+            m_baseEof = true;
+            m_blockAvailable.wakeAll();
+            return;
+        }
+
+        block.resize(bytesRead);
+
+        while (m_queue.size() >= m_maxBlocks && !m_stop) {
+            m_spaceAvailable.wait(&m_mutex);
+        }
+
+        m_queue.enqueue(block);
+        m_blockAvailable.wakeOne();
+    }
+}
+
+
+ReadAheadThread::ReadAheadThread(ReadAheadStream* stream)
+    : m_stream(stream)
+{
+}
+
+void ReadAheadThread::run()
+{
+    m_stream->readAhead();
+}
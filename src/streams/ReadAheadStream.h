@@ -0,0 +1,71 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_READAHEADSTREAM_H
+#define KEEPASSX_READAHEADSTREAM_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QMutex>
+#include <QtCore/QQueue>
+#include <QtCore/QWaitCondition>
+
+#include "streams/LayeredStream.h"
+
+class ReadAheadThread;
+
+// Reads the base device on a separate thread and passes the data on through a bounded queue.
+// The base device must not be accessed by anyone else while the stream is open.
+class ReadAheadStream : public LayeredStream
+{
+    Q_OBJECT
+
+public:
+    ReadAheadStream(QIODevice* baseDevice, int blockSize, int maxBlocks);
+    ~ReadAheadStream();
+
+    bool open(QIODevice::OpenMode mode) Q_DECL_OVERRIDE;
+    void close() Q_DECL_OVERRIDE;
+    QString errorString() const Q_DECL_OVERRIDE;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) Q_DECL_OVERRIDE;
+    qint64 writeData(const char* data, qint64 maxSize) Q_DECL_OVERRIDE;
+
+private:
+    void readAhead();
+    void stopThread();
+
+    const int m_blockSize;
+    const int m_maxBlocks;
+    ReadAheadThread* m_thread;
+
+    QMutex m_mutex;
+    QWaitCondition m_blockAvailable;
+    QWaitCondition m_spaceAvailable;
+    QQueue<QByteArray> m_queue;
+    bool m_baseEof;
+    bool m_baseError;
+    QString m_baseErrorString;
+    bool m_stop;
+
+    QByteArray m_buffer;
+    int m_bufferPos;
+
+    friend class ReadAheadThread;
+};
+
+#endif // KEEPASSX_READAHEADSTREAM_H
@@ -0,0 +1,39 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_READAHEADSTREAM_P_H
+#define KEEPASSX_READAHEADSTREAM_P_H
+
+#include <QtCore/QThread>
+
+class ReadAheadStream;
+
+class ReadAheadThread : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit ReadAheadThread(ReadAheadStream* stream);
+
+protected:
+    void run();
+
+private:
+    ReadAheadStream* const m_stream;
+};
+
+#endif // KEEPASSX_READAHEADSTREAM_P_H
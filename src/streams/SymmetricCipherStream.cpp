@@ -17,6 +17,8 @@
 
 #include "SymmetricCipherStream.h"
 
+const int SymmetricCipherStream::ChunkSize = 64 * 1024;
+
 SymmetricCipherStream::SymmetricCipherStream(QIODevice* baseDevice, SymmetricCipher::Algorithm algo,
                                              SymmetricCipher::Mode mode, SymmetricCipher::Direction direction,
                                              const QByteArray& key, const QByteArray& iv)
@@ -26,6 +28,7 @@ SymmetricCipherStream::SymmetricCipherStream(QIODevice* baseDevice, SymmetricCip
     , m_bufferFilling(false)
     , m_error(false)
 {
+    Q_ASSERT((ChunkSize % m_cipher->blockSize()) == 0);
 }
 
 SymmetricCipherStream::~SymmetricCipherStream()
@@ -96,14 +99,31 @@ qint64 SymmetricCipherStream::readData(char* data, qint64 maxSize)
 
 bool SymmetricCipherStream::readBlock()
 {
+    const int blockSize = m_cipher->blockSize();
+    int bufferSize;
+    int readSize;
+
     if (m_bufferFilling) {
-        m_buffer.append(m_baseDevice->read(m_cipher->blockSize() - m_buffer.size()));
+        // complete the partial block run from the previous short read
+        bufferSize = m_buffer.size();
+        readSize = (bufferSize == 0) ? ChunkSize : blockSize - (bufferSize % blockSize);
     }
     else {
-        m_buffer = m_baseDevice->read(m_cipher->blockSize());
+        bufferSize = 0;
+        readSize = ChunkSize;
+    }
+
+    m_buffer.reserve(ChunkSize);
+    m_buffer.resize(bufferSize + readSize);
+
+    qint64 bytesRead = m_baseDevice->read(m_buffer.data() + bufferSize, readSize);
+    if (bytesRead < 0) {
+        bytesRead = 0;
     }
 
-    if (m_buffer.size() != m_cipher->blockSize()) {
+    m_buffer.resize(bufferSize + bytesRead);
+
+    if (m_buffer.isEmpty() || (m_buffer.size() % blockSize) != 0) {
         m_bufferFilling = true;
         return false;
     }
@@ -116,13 +136,13 @@ bool SymmetricCipherStream::readBlock()
             // PKCS7 padding
             quint8 padLength = m_buffer.at(m_buffer.size() - 1);
 
-            if (padLength == m_cipher->blockSize()) {
-                Q_ASSERT(m_buffer == QByteArray(m_cipher->blockSize(), m_cipher->blockSize()));
+            if (padLength == blockSize) {
+                Q_ASSERT(m_buffer.right(blockSize) == QByteArray(blockSize, blockSize));
                 // full block with just padding: discard
-                m_buffer.clear();
-                return false;
+                m_buffer.resize(m_buffer.size() - blockSize);
+                return !m_buffer.isEmpty();
             }
-            else if (padLength > m_cipher->blockSize()) {
+            else if (padLength > blockSize) {
                 // invalid padding
                 m_error = true;
                 return false;
@@ -130,7 +150,7 @@ bool SymmetricCipherStream::readBlock()
             else {
                 Q_ASSERT(m_buffer.right(padLength) == QByteArray(padLength, padLength));
                 // resize buffer to strip padding
-                m_buffer.resize(m_cipher->blockSize() - padLength);
+                m_buffer.resize(m_buffer.size() - padLength);
                 return true;
             }
         }
@@ -148,18 +168,28 @@ qint64 SymmetricCipherStream::writeData(const char* data, qint64 maxSize)
         return -1;
     }
 
+    const int blockSize = m_cipher->blockSize();
     qint64 bytesRemaining = maxSize;
     qint64 offset = 0;
 
+    m_buffer.reserve(ChunkSize);
+
     while (bytesRemaining > 0) {
-        int bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(m_cipher->blockSize() - m_buffer.size()));
+        int bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(ChunkSize - m_buffer.size()));
+
+        // stop at a block boundary so complete blocks are written out immediately
+        // and only an incomplete trailing block stays in the buffer
+        int newBufferSize = m_buffer.size() + bytesToCopy;
+        if (newBufferSize > blockSize) {
+            bytesToCopy -= newBufferSize % blockSize;
+        }
 
         m_buffer.append(data + offset, bytesToCopy);
 
         offset += bytesToCopy;
         bytesRemaining -= bytesToCopy;
 
-        if (m_buffer.size() == m_cipher->blockSize()) {
+        if (!m_buffer.isEmpty() && (m_buffer.size() % blockSize) == 0) {
             if (!writeBlock(false)) {
                 if (m_error) {
                     return -1;
@@ -178,7 +208,7 @@ bool SymmetricCipherStream::writeBlock(bool lastBlock)
 {
     if (lastBlock) {
         // PKCS7 padding
-        int padLen = m_cipher->blockSize() - m_buffer.size();
+        int padLen = m_cipher->blockSize() - (m_buffer.size() % m_cipher->blockSize());
         for (int i = 0; i < padLen; i++) {
             m_buffer.append(static_cast<char>(padLen));
         }
@@ -195,7 +225,7 @@ bool SymmetricCipherStream::writeBlock(bool lastBlock)
         return false;
     }
     else {
-        m_buffer.clear();
+        m_buffer.resize(0);
         return true;
     }
 }
@@ -43,6 +43,9 @@ private:
     bool readBlock();
     bool writeBlock(bool lastBlock);
 
+    // number of bytes passed to the cipher at once, a multiple of every supported block size
+    static const int ChunkSize;
+
     const QScopedPointer<SymmetricCipher> m_cipher;
     QByteArray m_buffer;
     int m_bufferPos;
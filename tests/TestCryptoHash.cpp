@@ -48,4 +48,40 @@ void TestCryptoHash::test()
              QByteArray::fromHex("0b56e5f65263e747af4a833bd7dd7ad26a64d7a4de7c68e52364893dca0766b4"));
 }
 
+void TestCryptoHash::testBatch()
+{
+    QCOMPARE(CryptoHash::hashSize(CryptoHash::Sha256), 32);
+
+    char result[32];
+    QByteArray source = QString("KeePassX").toLatin1();
+    CryptoHash::hash(source.constData(), source.size(), result, CryptoHash::Sha256);
+    QCOMPARE(QByteArray(result, sizeof(result)),
+             QByteArray::fromHex("0b56e5f65263e747af4a833bd7dd7ad26a64d7a4de7c68e52364893dca0766b4"));
+
+    QVERIFY(CryptoHash::hashes(QList<QByteArray>(), CryptoHash::Sha256).isEmpty());
+
+    // small batches are hashed sequentially, large ones in parallel
+    QList<int> sizes;
+    sizes << 100 << 1024 * 1024;
+
+    Q_FOREACH (int size, sizes) {
+        QList<QByteArray> data;
+        data << QByteArray() << source;
+        for (int i = 0; i < 8; i++) {
+            data << QByteArray(size, static_cast<char>(i));
+        }
+
+        QList<QByteArray> hashes = CryptoHash::hashes(data, CryptoHash::Sha256);
+        QCOMPARE(hashes.size(), data.size());
+        QCOMPARE(hashes[0],
+                 QByteArray::fromHex("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+
+        for (int i = 0; i < data.size(); i++) {
+            CryptoHash cryptoHash(CryptoHash::Sha256);
+            cryptoHash.addData(data[i]);
+            QCOMPARE(hashes[i], cryptoHash.result());
+        }
+    }
+}
+
 QTEST_GUILESS_MAIN(TestCryptoHash)
@@ -27,6 +27,7 @@ class TestCryptoHash : public QObject
 private Q_SLOTS:
     void initTestCase();
     void test();
+    void testBatch();
 };
 
 #endif // KEEPASSX_TESTCRYPTOHASH_H
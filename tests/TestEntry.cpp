@@ -20,7 +20,14 @@
 #include <QtTest/QTest>
 
 #include "tests.h"
+#include "core/AttachmentStore.h"
 #include "core/Entry.h"
+#include "crypto/Crypto.h"
+
+void TestEntry::initTestCase()
+{
+    Crypto::init();
+}
 
 void TestEntry::testHistoryItemDeletion()
 {
@@ -74,4 +81,44 @@ void TestEntry::testCopyDataFrom()
     QCOMPARE(entry2->autoTypeAssociations()->get(1).window, QString("3"));
 }
 
+void TestEntry::testAttachmentStore()
+{
+    int storeCount = attachmentStore()->count();
+
+    Entry* entry1 = new Entry();
+    entry1->attachments()->set("a", QByteArray("attachment data"));
+    entry1->attachments()->set("b", QByteArray("attachment data"));
+    QCOMPARE(attachmentStore()->count(), storeCount + 1);
+    QCOMPARE(entry1->attachments()->hash("a"), entry1->attachments()->hash("b"));
+    QCOMPARE(attachmentStore()->size(entry1->attachments()->hash("a")), 15);
+
+    Entry* entry2 = new Entry();
+    entry2->attachments()->set("c", QByteArray("attachment data"));
+    entry2->attachments()->set("d", QByteArray("other data"));
+    QCOMPARE(attachmentStore()->count(), storeCount + 2);
+
+    Entry* clone = entry2->clone();
+    QCOMPARE(attachmentStore()->count(), storeCount + 2);
+    QCOMPARE(clone->attachments()->value("d"), QByteArray("other data"));
+
+    entry2->attachments()->set("d", QByteArray("changed data"));
+    QCOMPARE(attachmentStore()->count(), storeCount + 3);
+    QCOMPARE(clone->attachments()->value("d"), QByteArray("other data"));
+    QCOMPARE(entry2->attachments()->value("d"), QByteArray("changed data"));
+
+    delete clone;
+    QCOMPARE(attachmentStore()->count(), storeCount + 2);
+
+    entry2->attachments()->clear();
+    QCOMPARE(attachmentStore()->count(), storeCount + 1);
+    QCOMPARE(entry1->attachments()->value("a"), QByteArray("attachment data"));
+
+    entry1->attachments()->remove("a");
+    QCOMPARE(attachmentStore()->count(), storeCount + 1);
+
+    delete entry1;
+    delete entry2;
+    QCOMPARE(attachmentStore()->count(), storeCount);
+}
+
 QTEST_GUILESS_MAIN(TestEntry)
@@ -32,6 +32,7 @@
 #include "gui/entry/EntryModel.h"
 #include "gui/entry/EntryAttachmentsModel.h"
 #include "gui/entry/EntryAttributesModel.h"
+#include "gui/entry/EntrySortModel.h"
 
 void TestEntryModel::initTestCase()
 {
@@ -342,4 +343,239 @@ void TestEntryModel::testDatabaseDelete()
     delete model;
 }
 
+void TestEntryModel::testEntryRows()
+{
+    Database* db = new Database();
+    Group* group1 = new Group();
+    group1->setParent(db->rootGroup());
+    Group* group2 = new Group();
+    group2->setParent(db->rootGroup());
+
+    QList<Entry*> entries;
+    for (int i = 0; i < 50; i++) {
+        Entry* entry = new Entry();
+        entry->setGroup(group1);
+        entries.append(entry);
+    }
+
+    EntryModel* model = new EntryModel(this);
+    ModelTest* modelTest = new ModelTest(model, this);
+
+    model->setGroup(group1);
+
+    // remove rows from the middle and add them again at the end
+    for (int i = 10; i < 40; i += 3) {
+        entries[i]->setGroup(group2);
+    }
+    for (int i = 10; i < 40; i += 6) {
+        entries[i]->setGroup(group1);
+    }
+
+    QCOMPARE(model->rowCount(), group1->entries().size());
+    Q_FOREACH (Entry* entry, group1->entries()) {
+        QCOMPARE(model->indexFromEntry(entry).row(), group1->entries().indexOf(entry));
+        QCOMPARE(model->entryFromIndex(model->indexFromEntry(entry)), entry);
+    }
+
+    QSignalSpy spyDataChanged(model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    Entry* entry = group1->entries().at(20);
+    entry->setTitle("changed");
+    QCOMPARE(spyDataChanged.count(), 1);
+    QCOMPARE(spyDataChanged.first().first().value<QModelIndex>().row(), 20);
+
+    // entries of other groups are ignored
+    entries[13]->setTitle("changed");
+    QCOMPARE(spyDataChanged.count(), 1);
+
+    model->setEntryList(QList<Entry*>() << entries[0] << entries[13] << entries[49]);
+    QCOMPARE(model->indexFromEntry(entries[13]).row(), 1);
+
+    entries[0]->setGroup(group2);
+    QCOMPARE(model->rowCount(), 3);
+    QCOMPARE(model->indexFromEntry(entries[13]).row(), 0);
+    QCOMPARE(model->indexFromEntry(entries[49]).row(), 1);
+    QCOMPARE(model->indexFromEntry(entries[0]).row(), 2);
+
+    delete modelTest;
+    delete model;
+
+    delete db;
+}
+
+void TestEntryModel::testMoveManyEntries()
+{
+    Database* db = new Database();
+    Group* group1 = new Group();
+    group1->setParent(db->rootGroup());
+    Group* group2 = new Group();
+    group2->setParent(db->rootGroup());
+
+    QList<Entry*> entries;
+    for (int i = 0; i < 3000; i++) {
+        Entry* entry = new Entry();
+        entry->setGroup(group1);
+        entries.append(entry);
+    }
+
+    EntryModel* model = new EntryModel(this);
+    model->setGroup(group1);
+
+    QSignalSpy spyAboutToRemove(model, SIGNAL(rowsAboutToBeRemoved(QModelIndex,int,int)));
+
+    // from the top, every removal moves all later rows
+    for (int i = 0; i < 1000; i++) {
+        entries[i]->setGroup(group2);
+        QCOMPARE(spyAboutToRemove.takeFirst().at(1).toInt(), 0);
+    }
+
+    // scattered, from the bottom and moved back
+    for (int i = 1000; i < 3000; i += 7) {
+        entries[i]->setGroup(group2);
+    }
+    for (int i = 2999; i >= 2500; i -= 2) {
+        entries[i]->setGroup(group2);
+    }
+    for (int i = 1500; i < 2000; i += 5) {
+        entries[i]->setGroup(group1);
+    }
+
+    QCOMPARE(model->rowCount(), group1->entries().size());
+    for (int row = 0; row < group1->entries().size(); row++) {
+        Entry* entry = group1->entries().at(row);
+        QCOMPARE(model->indexFromEntry(entry).row(), row);
+        QCOMPARE(model->entryFromIndex(model->index(row, 1)), entry);
+    }
+
+    delete model;
+    delete db;
+}
+
+void TestEntryModel::testEntryListSignals()
+{
+    Database* db = new Database();
+    Group* group1 = new Group();
+    group1->setParent(db->rootGroup());
+
+    Entry* entry1 = new Entry();
+    entry1->setGroup(group1);
+    Entry* entry2 = new Entry();
+    entry2->setGroup(db->rootGroup());
+
+    EntryModel* model = new EntryModel(this);
+    ModelTest* modelTest = new ModelTest(model, this);
+
+    model->setEntryList(QList<Entry*>() << entry1 << entry2);
+
+    // groups that are added after the search are covered as well
+    Group* group2 = new Group();
+    group2->setParent(group1);
+
+    entry1->setGroup(group2);
+    QCOMPARE(model->rowCount(), 2);
+    QCOMPARE(model->indexFromEntry(entry1).row(), 1);
+
+    QSignalSpy spyDataChanged(model, SIGNAL(dataChanged(QModelIndex,QModelIndex)));
+    entry1->setTitle("changed");
+    QCOMPARE(spyDataChanged.count(), 1);
+    QCOMPARE(spyDataChanged.first().first().value<QModelIndex>().row(), 1);
+
+    // entries that are not part of the result are ignored
+    Entry* entry3 = new Entry();
+    entry3->setGroup(group2);
+    entry3->setTitle("changed");
+    QCOMPARE(model->rowCount(), 2);
+    QCOMPARE(spyDataChanged.count(), 1);
+
+    // no notifications from the database after switching back to a group
+    model->setGroup(group1);
+    QCOMPARE(model->rowCount(), 0);
+    entry1->setTitle("changed again");
+    QCOMPARE(spyDataChanged.count(), 1);
+
+    delete modelTest;
+    delete model;
+
+    delete db;
+}
+
+void TestEntryModel::testSortKeys()
+{
+    Database* db = new Database();
+    Group* group = new Group();
+    group->setParent(db->rootGroup());
+
+    Entry* entry1 = new Entry();
+    entry1->setGroup(group);
+    entry1->setTitle("B");
+    entry1->setUsername("z");
+    Entry* entry2 = new Entry();
+    entry2->setGroup(group);
+    entry2->setTitle("a");
+    entry2->setUsername("y");
+
+    EntryModel* model = new EntryModel(this);
+    model->setGroup(group);
+
+    QModelIndex title1 = model->index(0, EntryModel::Title);
+    QModelIndex title2 = model->index(1, EntryModel::Title);
+    QModelIndex username1 = model->index(0, EntryModel::Username);
+    QModelIndex username2 = model->index(1, EntryModel::Username);
+
+    // case insensitive, "B" < "a" when comparing case sensitively
+    QVERIFY(model->lessThan(title2, title1));
+    QVERIFY(!model->lessThan(title1, title2));
+    QVERIFY(model->lessThan(username2, username1));
+
+    // cached keys are dropped when the entry changes
+    entry2->setTitle("c");
+    QVERIFY(model->lessThan(title1, title2));
+    QVERIFY(model->lessThan(username2, username1));
+
+    entry1->setUsername("x");
+    QVERIFY(model->lessThan(username1, username2));
+
+    delete model;
+    delete db;
+}
+
+void TestEntryModel::testSortManyEntries()
+{
+    const int count = 1200;
+
+    Database* db = new Database();
+    Group* group = new Group();
+    group->setParent(db->rootGroup());
+
+    // add the entries in a scrambled order
+    for (int i = 0; i < count; i++) {
+        Entry* entry = new Entry();
+        entry->setGroup(group);
+        entry->setTitle(QString("Entry %1").arg((i * 7) % count, 4, 10, QLatin1Char('0')));
+    }
+
+    EntryModel* model = new EntryModel(this);
+    model->setGroup(group);
+
+    EntrySortModel* sortModel = new EntrySortModel(model);
+    sortModel->setDynamicSortFilter(true);
+    sortModel->sort(EntryModel::Title);
+
+    // all entries are sorted, not only the first rows
+    QCOMPARE(sortModel->rowCount(), count);
+    for (int row = 0; row < count; row++) {
+        QCOMPARE(sortModel->index(row, EntryModel::Title).data().toString(),
+                 QString("Entry %1").arg(row, 4, 10, QLatin1Char('0')));
+    }
+
+    Entry* entry = new Entry();
+    entry->setGroup(group);
+    entry->setTitle("entry 0000a");
+    QCOMPARE(sortModel->index(1, EntryModel::Title).data().toString(), QString("entry 0000a"));
+
+    delete sortModel;
+    delete model;
+
+    delete db;
+}
+
 QTEST_GUILESS_MAIN(TestEntryModel)
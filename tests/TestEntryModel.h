@@ -34,6 +34,11 @@ private Q_SLOTS:
     void testAutoTypeAssociationsModel();
     void testProxyModel();
     void testDatabaseDelete();
+    void testEntryRows();
+    void testMoveManyEntries();
+    void testEntryListSignals();
+    void testSortKeys();
+    void testSortManyEntries();
 };
 
 #endif // KEEPASSX_TESTENTRYMODEL_H
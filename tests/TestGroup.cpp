@@ -25,6 +25,7 @@
 #include "core/Database.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
+#include "core/SearchSession.h"
 #include "crypto/Crypto.h"
 
 void TestGroup::initTestCase()
@@ -294,6 +295,26 @@ void TestGroup::testDeleteSignals()
     delete db2;
 }
 
+void TestGroup::testExpandedModified()
+{
+    Group* group = new Group();
+    QSignalSpy spyModified(group, SIGNAL(modified()));
+
+    group->setExpanded(false);
+    QCOMPARE(spyModified.count(), 1);
+
+    group->setExpanded(true, false);
+    QVERIFY(group->isExpanded());
+    QCOMPARE(spyModified.count(), 1);
+
+    // independent of the time info updates
+    group->setUpdateTimeinfo(false);
+    group->setExpanded(false);
+    QCOMPARE(spyModified.count(), 2);
+
+    delete group;
+}
+
 void TestGroup::testCopyCustomIcon()
 {
     Database* dbSource = new Database();
@@ -430,6 +451,87 @@ void TestGroup::testAndConcatenationInSearch()
     delete group;
 }
 
+void TestGroup::testSearchIndex()
+{
+    Database* db = new Database();
+
+    Group* group1 = new Group();
+    group1->setParent(db->rootGroup());
+    Group* group2 = new Group();
+    group2->setParent(db->rootGroup());
+    group2->setSearchingEnabled(Group::Disable);
+    Group* group21 = new Group();
+    group21->setParent(group2);
+    group21->setSearchingEnabled(Group::Enable);
+
+    Entry* entry1 = new Entry();
+    entry1->setTitle("Mail Account");
+    entry1->setGroup(group1);
+
+    Entry* entry2 = new Entry();
+    entry2->setUrl("https://mail.example.com");
+    entry2->setGroup(db->rootGroup());
+
+    Entry* entry3 = new Entry();
+    entry3->setUsername("mailuser");
+    entry3->setGroup(group2);
+
+    Entry* entry4 = new Entry();
+    entry4->setNotes("old mail server");
+    entry4->setGroup(group21);
+
+    QList<Entry*> searchResult;
+
+    // group21 is skipped as its parent group is excluded from searching
+    searchResult = db->rootGroup()->search("mail", Qt::CaseInsensitive);
+    QCOMPARE(searchResult.size(), 2);
+    QCOMPARE(searchResult.at(0), entry2);
+    QCOMPARE(searchResult.at(1), entry1);
+
+    searchResult = db->rootGroup()->search("MAIL", Qt::CaseSensitive);
+    QCOMPARE(searchResult.size(), 0);
+
+    searchResult = db->rootGroup()->search("Mail acc", Qt::CaseSensitive);
+    QCOMPARE(searchResult.size(), 0);
+
+    searchResult = db->rootGroup()->search("Mail Acc", Qt::CaseSensitive);
+    QCOMPARE(searchResult.size(), 1);
+
+    searchResult = group2->search("mail", Qt::CaseInsensitive);
+    QCOMPARE(searchResult.size(), 0);
+
+    searchResult = group21->search("mail", Qt::CaseInsensitive);
+    QCOMPARE(searchResult.size(), 1);
+    QCOMPARE(searchResult.at(0), entry4);
+
+    searchResult = db->rootGroup()->search("xyz", Qt::CaseInsensitive);
+    QCOMPARE(searchResult.size(), 0);
+
+    entry1->setTitle("Bank xyz");
+    searchResult = db->rootGroup()->search("xyz", Qt::CaseInsensitive);
+    QCOMPARE(searchResult.size(), 1);
+    QCOMPARE(searchResult.at(0), entry1);
+    searchResult = db->rootGroup()->search("account", Qt::CaseInsensitive);
+    QCOMPARE(searchResult.size(), 0);
+
+    // words shorter than the index granularity
+    searchResult = db->rootGroup()->search("xy", Qt::CaseInsensitive);
+    QCOMPARE(searchResult.size(), 1);
+
+    delete entry1;
+    searchResult = db->rootGroup()->search("xyz", Qt::CaseInsensitive);
+    QCOMPARE(searchResult.size(), 0);
+
+    Group* tmpGroup = new Group();
+    entry2->setGroup(tmpGroup);
+    searchResult = db->rootGroup()->search("mail", Qt::CaseInsensitive);
+    QCOMPARE(searchResult.size(), 0);
+    QCOMPARE(tmpGroup->search("mail", Qt::CaseInsensitive).size(), 1);
+
+    delete tmpGroup;
+    delete db;
+}
+
 void TestGroup::testClone()
 {
     Database* db = new Database();
@@ -533,4 +635,110 @@ void TestGroup::testCopyCustomIcons()
     QCOMPARE(metaTarget->customIcon(group2Icon).pixel(0, 0), qRgb(4, 5, 6));
 }
 
+void TestGroup::testResolveUuid()
+{
+    Database* db = new Database();
+    Database* db2 = new Database();
+
+    QCOMPARE(db->resolveGroup(db->rootGroup()->uuid()), db->rootGroup());
+
+    Group* group = new Group();
+    group->setUuid(Uuid::random());
+    Entry* entry = new Entry();
+    entry->setUuid(Uuid::random());
+    entry->setGroup(group);
+
+    QVERIFY(!db->resolveGroup(group->uuid()));
+    QVERIFY(!db->resolveEntry(entry->uuid()));
+
+    group->setParent(db->rootGroup());
+    QCOMPARE(db->resolveGroup(group->uuid()), group);
+    QCOMPARE(db->resolveEntry(entry->uuid()), entry);
+
+    Uuid oldGroupUuid = group->uuid();
+    Uuid oldEntryUuid = entry->uuid();
+    group->setUuid(Uuid::random());
+    entry->setUuid(Uuid::random());
+    QVERIFY(!db->resolveGroup(oldGroupUuid));
+    QVERIFY(!db->resolveEntry(oldEntryUuid));
+    QCOMPARE(db->resolveGroup(group->uuid()), group);
+    QCOMPARE(db->resolveEntry(entry->uuid()), entry);
+
+    entry->setGroup(db->rootGroup());
+    QCOMPARE(db->resolveEntry(entry->uuid()), entry);
+
+    group->setParent(db2->rootGroup());
+    QVERIFY(!db->resolveGroup(group->uuid()));
+    QCOMPARE(db2->resolveGroup(group->uuid()), group);
+
+    entry->setGroup(group);
+    QVERIFY(!db->resolveEntry(entry->uuid()));
+    QCOMPARE(db2->resolveEntry(entry->uuid()), entry);
+
+    Uuid entryUuid = entry->uuid();
+    Uuid groupUuid = group->uuid();
+    delete group;
+    QVERIFY(!db2->resolveGroup(groupUuid));
+    QVERIFY(!db2->resolveEntry(entryUuid));
+
+    delete db;
+    delete db2;
+}
+
+void TestGroup::testSearchSession()
+{
+    QVERIFY(SearchSession::isRefinement(QStringList() << "mai", QStringList() << "mail", Qt::CaseSensitive));
+    QVERIFY(SearchSession::isRefinement(QStringList() << "mail", QStringList() << "mail" << "acc",
+                                        Qt::CaseSensitive));
+    QVERIFY(SearchSession::isRefinement(QStringList(), QStringList() << "mail", Qt::CaseSensitive));
+    QVERIFY(SearchSession::isRefinement(QStringList() << "MAIL", QStringList() << "mail", Qt::CaseInsensitive));
+    QVERIFY(!SearchSession::isRefinement(QStringList() << "MAIL", QStringList() << "mail", Qt::CaseSensitive));
+    QVERIFY(!SearchSession::isRefinement(QStringList() << "mail", QStringList() << "mai", Qt::CaseSensitive));
+
+    Database* db = new Database();
+
+    Group* group1 = new Group();
+    group1->setParent(db->rootGroup());
+
+    Entry* entry1 = new Entry();
+    entry1->setTitle("Mail Account");
+    entry1->setGroup(group1);
+
+    Entry* entry2 = new Entry();
+    entry2->setUrl("https://mail.example.com");
+    entry2->setGroup(db->rootGroup());
+
+    Entry* entry3 = new Entry();
+    entry3->setUsername("mailuser");
+    entry3->setGroup(group1);
+
+    SearchSession session;
+    QList<Entry*> searchResult;
+
+    searchResult = session.search(db->rootGroup(), "ma", Qt::CaseInsensitive);
+    QCOMPARE(searchResult, db->rootGroup()->search("ma", Qt::CaseInsensitive));
+    QCOMPARE(searchResult.size(), 3);
+
+    searchResult = session.search(db->rootGroup(), "mail acc", Qt::CaseInsensitive);
+    QCOMPARE(searchResult, QList<Entry*>() << entry1);
+
+    // a modification drops the previous results
+    entry2->setTitle("Mail Account Backup");
+    searchResult = session.search(db->rootGroup(), "mail account", Qt::CaseInsensitive);
+    QCOMPARE(searchResult, db->rootGroup()->search("mail account", Qt::CaseInsensitive));
+    QCOMPARE(searchResult.size(), 2);
+
+    // not a refinement anymore
+    searchResult = session.search(db->rootGroup(), "mail", Qt::CaseInsensitive);
+    QCOMPARE(searchResult.size(), 3);
+
+    searchResult = session.search(group1, "mail", Qt::CaseInsensitive);
+    QCOMPARE(searchResult, group1->search("mail", Qt::CaseInsensitive));
+
+    searchResult = session.search(group1, "Mail", Qt::CaseSensitive);
+    QCOMPARE(searchResult, QList<Entry*>() << entry1);
+
+    delete db;
+}
+
 QTEST_GUILESS_MAIN(TestGroup)
@@ -30,11 +30,15 @@ private Q_SLOTS:
     void testSignals();
     void testEntries();
     void testDeleteSignals();
+    void testExpandedModified();
     void testCopyCustomIcon();
     void testSearch();
     void testAndConcatenationInSearch();
+    void testSearchIndex();
+    void testSearchSession();
     void testClone();
     void testCopyCustomIcons();
+    void testResolveUuid();
 };
 
 #endif // KEEPASSX_TESTGROUP_H
@@ -150,4 +150,70 @@ void TestGroupModel::test()
     delete model;
 }
 
+void TestGroupModel::testFetchMore()
+{
+    Database* db = new Database();
+    Group* groupRoot = db->rootGroup();
+
+    QList<Group*> groups;
+    for (int i = 0; i < GroupModel::FetchBatchSize + 10; i++) {
+        Group* group = new Group();
+        group->setParent(groupRoot);
+        groups.append(group);
+    }
+
+    GroupModel* model = new GroupModel(db, this);
+
+    QModelIndex indexRoot = model->index(0, 0);
+    QCOMPARE(model->rowCount(indexRoot), GroupModel::FetchBatchSize);
+    QVERIFY(model->canFetchMore(indexRoot));
+    QVERIFY(model->index(groups.first()).isValid());
+    QVERIFY(!model->index(groups.last()).isValid());
+
+    QSignalSpy spyInserted(model, SIGNAL(rowsInserted(QModelIndex,int,int)));
+    QSignalSpy spyRemoved(model, SIGNAL(rowsRemoved(QModelIndex,int,int)));
+    QSignalSpy spyMoved(model, SIGNAL(rowsMoved(QModelIndex,int,int,QModelIndex,int)));
+
+    // groups after the fetched children don't have rows
+    Group* group1 = new Group();
+    group1->setParent(groupRoot);
+    delete groups.takeLast();
+    QCOMPARE(spyInserted.count(), 0);
+    QCOMPARE(spyRemoved.count(), 0);
+
+    // moved behind the fetched children
+    groups.first()->setParent(groupRoot);
+    QCOMPARE(spyRemoved.count(), 1);
+    QCOMPARE(spyMoved.count(), 0);
+    QCOMPARE(model->rowCount(indexRoot), GroupModel::FetchBatchSize - 1);
+
+    Group* group2 = new Group();
+    group2->setParent(groupRoot, 0);
+    QCOMPARE(spyInserted.count(), 1);
+    QCOMPARE(model->rowCount(indexRoot), GroupModel::FetchBatchSize);
+
+    // moved within the fetched children
+    group2->setParent(groupRoot, 1);
+    QCOMPARE(spyMoved.count(), 1);
+
+    Group* group11 = new Group();
+    group11->setParent(group1);
+
+    model->fetchGroup(group11);
+    QVERIFY(model->index(group11).isValid());
+    QCOMPARE(model->rowCount(indexRoot), groupRoot->children().size());
+    QVERIFY(!model->canFetchMore(indexRoot));
+
+    for (int row = 0; row < model->rowCount(indexRoot); row++) {
+        QCOMPARE(model->groupFromIndex(model->index(row, 0, indexRoot)), groupRoot->children().at(row));
+    }
+
+    ModelTest* modelTest = new ModelTest(model, this);
+
+    delete modelTest;
+    delete model;
+
+    delete db;
+}
+
 QTEST_GUILESS_MAIN(TestGroupModel)
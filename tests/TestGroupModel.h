@@ -27,6 +27,7 @@ class TestGroupModel : public QObject
 private Q_SLOTS:
     void initTestCase();
     void test();
+    void testFetchMore();
 };
 
 #endif // KEEPASSX_TESTGROUPMODEL_H
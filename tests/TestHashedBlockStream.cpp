@@ -70,4 +70,33 @@ void TestHashedBlockStream::testWriteRead()
     buffer.buffer().clear();
 }
 
+void TestHashedBlockStream::testCorruptedBlock()
+{
+    QByteArray data = QByteArray::fromHex("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4");
+
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+
+    HashedBlockStream writer(&buffer, 16);
+    writer.open(QIODevice::WriteOnly);
+    writer.write(data);
+    QVERIFY(writer.reset());
+
+    // flip a byte in the data of the first block (after index, hash and size)
+    buffer.buffer()[40] = buffer.buffer().at(40) ^ 0x01;
+
+    // block read directly into the caller's buffer
+    buffer.reset();
+    HashedBlockStream reader(&buffer);
+    reader.open(QIODevice::ReadOnly);
+    char readData[32];
+    QCOMPARE(reader.read(readData, 32), static_cast<qint64>(-1));
+
+    // block read into the internal buffer
+    buffer.reset();
+    HashedBlockStream reader2(&buffer);
+    reader2.open(QIODevice::ReadOnly);
+    QCOMPARE(reader2.read(readData, 5), static_cast<qint64>(-1));
+}
+
 QTEST_GUILESS_MAIN(TestHashedBlockStream)
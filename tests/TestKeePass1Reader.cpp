@@ -254,6 +254,47 @@ void TestKeePass1Reader::testCP1252Password()
     delete db;
 }
 
+void TestKeePass1Reader::testLatin1Password()
+{
+    QString name = "Latin-1";
+
+    KeePass1Reader reader;
+
+    // KeePassX up to 0.3.1 encoded the password as Latin-1, the euro sign became '?'
+    QString dbFilename = QString("%1/%2.kdb").arg(QString(KEEPASSX_TEST_DATA_DIR), name);
+    QString password = QString::fromUtf8("\xe2\x82\xac\x70\x61\x73\x73\x77\x6f\x72\x64");
+
+    Database* db = reader.readDatabase(dbFilename, password, 0);
+    QVERIFY(db);
+    QVERIFY(!reader.hasError());
+    QCOMPARE(db->rootGroup()->children().size(), 1);
+    QCOMPARE(db->rootGroup()->children().at(0)->name(), name);
+
+    delete db;
+}
+
+void TestKeePass1Reader::testWrongPassword()
+{
+    QString name = "Latin-1";
+
+    KeePass1Reader reader;
+
+    // Windows-1252, Latin-1 and UTF-8 encode the euro sign differently so all three are tried
+    QString dbFilename = QString("%1/%2.kdb").arg(QString(KEEPASSX_TEST_DATA_DIR), name);
+    QString password = QString::fromUtf8("\xe2\x82\xac\x77\x72\x6f\x6e\x67");
+
+    Database* db = reader.readDatabase(dbFilename, password, 0);
+    QVERIFY(!db);
+
+    // the reader can be used again once all key derivations have finished
+    password = QString::fromUtf8("\xe2\x82\xac\x70\x61\x73\x73\x77\x6f\x72\x64");
+    db = reader.readDatabase(dbFilename, password, 0);
+    QVERIFY(db);
+    QCOMPARE(db->rootGroup()->children().at(0)->name(), name);
+
+    delete db;
+}
+
 void TestKeePass1Reader::cleanupTestCase()
 {
     delete m_db;
@@ -39,6 +39,8 @@ private Q_SLOTS:
     void testCompositeKey();
     void testTwofish();
     void testCP1252Password();
+    void testLatin1Password();
+    void testWrongPassword();
     void cleanupTestCase();
 
 private:
@@ -78,4 +78,41 @@ void TestKeePass2RandomStream::test()
     QCOMPARE(randomStreamData, cipherData);
 }
 
+void TestKeePass2RandomStream::testLargeData()
+{
+    const QByteArray key("\x11\x22\x33\x44\x55\x66\x77\x88");
+    const int Size = 10007;
+
+    QByteArray data;
+    data.resize(Size);
+    for (int i = 0; i < Size; i++) {
+        data[i] = static_cast<char>(i * 7);
+    }
+
+    SymmetricCipher cipher(SymmetricCipher::Salsa20, SymmetricCipher::Stream, SymmetricCipher::Encrypt,
+                           CryptoHash::hash(key, CryptoHash::Sha256), KeePass2::INNER_STREAM_SALSA20_IV);
+    QByteArray cipherData = cipher.process(data);
+
+    // odd chunk sizes so that reads straddle the key stream batches
+    KeePass2RandomStream randomStream(key);
+    QByteArray randomStreamData;
+    int offset = 0;
+    int chunkSize = 1;
+    while (offset < Size) {
+        QByteArray chunk = data.mid(offset, chunkSize);
+        if (chunkSize % 2 == 0) {
+            randomStream.processInPlace(chunk);
+            randomStreamData.append(chunk);
+        }
+        else {
+            randomStreamData.append(randomStream.process(chunk));
+        }
+        offset += chunk.size();
+        chunkSize = (chunkSize * 3 + 1) % 1500;
+    }
+
+    QCOMPARE(randomStreamData.size(), Size);
+    QCOMPARE(randomStreamData, cipherData);
+}
+
 QTEST_GUILESS_MAIN(TestKeePass2RandomStream)
@@ -27,6 +27,7 @@ class TestKeePass2RandomStream : public QObject
 private Q_SLOTS:
     void initTestCase();
     void test();
+    void testLargeData();
 };
 
 #endif // KEEPASSX_TESTKEEPASS2RANDOMSTREAM_H
@@ -17,14 +17,18 @@
 
 #include "TestKeePass2Reader.h"
 
+#include <QtTest/QSignalSpy>
 #include <QtTest/QTest>
 
 #include "config-keepassx-tests.h"
 #include "tests.h"
 #include "core/Database.h"
+#include "core/Entry.h"
+#include "core/EntryAttributes.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "crypto/Crypto.h"
+#include "format/KeePass2AsyncReader.h"
 #include "format/KeePass2Reader.h"
 #include "keys/PasswordKey.h"
 
@@ -155,4 +159,112 @@ void TestKeePass2Reader::testFormat300()
     delete db;
 }
 
+void TestKeePass2Reader::testPipelined()
+{
+    QStringList filenames;
+    filenames << "/Compressed.kdbx" << "/NonAscii.kdbx";
+    QStringList passwords;
+    passwords << "" << QString::fromUtf8("\xce\x94\xc3\xb6\xd8\xb6");
+
+    for (int i = 0; i < filenames.size(); i++) {
+        QString filename = QString(KEEPASSX_TEST_DATA_DIR).append(filenames[i]);
+        CompositeKey key;
+        key.addKey(PasswordKey(passwords[i]));
+
+        KeePass2Reader reader;
+        reader.setSaveXml(true);
+        Database* db = reader.readDatabase(filename, key);
+        QVERIFY(db);
+        QVERIFY(!reader.hasError());
+
+        KeePass2Reader pipelinedReader;
+        pipelinedReader.setSaveXml(true);
+        pipelinedReader.setPipelined(true);
+        Database* pipelinedDb = pipelinedReader.readDatabase(filename, key);
+        QVERIFY(pipelinedDb);
+        QVERIFY(!pipelinedReader.hasError());
+
+        QCOMPARE(pipelinedReader.xmlData(), reader.xmlData());
+        QCOMPARE(pipelinedDb->metadata()->name(), db->metadata()->name());
+
+        delete db;
+        delete pipelinedDb;
+    }
+}
+
+void TestKeePass2Reader::testAsyncRead()
+{
+    QString filename = QString(KEEPASSX_TEST_DATA_DIR).append("/NonAscii.kdbx");
+    CompositeKey key;
+    key.addKey(PasswordKey(QString::fromUtf8("\xce\x94\xc3\xb6\xd8\xb6")));
+
+    KeePass2AsyncReader reader;
+    QSignalSpy finishedSpy(&reader, SIGNAL(finished()));
+    QSignalSpy progressSpy(&reader, SIGNAL(progressChanged(int)));
+
+    reader.readDatabase(filename, key);
+    QVERIFY(finishedSpy.wait());
+
+    QVERIFY(!reader.isCanceled());
+    QScopedPointer<Database> db(reader.takeDatabase());
+    QVERIFY(db);
+    QCOMPARE(db->metadata()->name(), QString("NonAsciiTest"));
+    QCOMPARE(db->thread(), reader.thread());
+    QVERIFY(!progressSpy.isEmpty());
+    QCOMPARE(progressSpy.last().at(0).toInt(), 100);
+
+    CompositeKey wrongKey;
+    wrongKey.addKey(PasswordKey("wrong"));
+    reader.readDatabase(filename, wrongKey);
+    QVERIFY(finishedSpy.wait());
+
+    QVERIFY(!reader.isCanceled());
+    QVERIFY(!reader.takeDatabase());
+    QVERIFY(!reader.errorString().isEmpty());
+}
+
+void TestKeePass2Reader::testAsyncReadCanceled()
+{
+    QString filename = QString(KEEPASSX_TEST_DATA_DIR).append("/NonAscii.kdbx");
+    CompositeKey key;
+    key.addKey(PasswordKey(QString::fromUtf8("\xce\x94\xc3\xb6\xd8\xb6")));
+
+    KeePass2AsyncReader reader;
+    QSignalSpy finishedSpy(&reader, SIGNAL(finished()));
+
+    reader.readDatabase(filename, key);
+    reader.cancel();
+    QVERIFY(finishedSpy.wait());
+
+    QVERIFY(reader.isCanceled());
+    QVERIFY(!reader.takeDatabase());
+}
+
+void TestKeePass2Reader::testAsyncReadHistory()
+{
+    QString filename = QString(KEEPASSX_TEST_DATA_DIR).append("/Format200.kdbx");
+    CompositeKey key;
+    key.addKey(PasswordKey("a"));
+
+    KeePass2AsyncReader reader;
+    QSignalSpy finishedSpy(&reader, SIGNAL(finished()));
+
+    reader.readDatabase(filename, key);
+    QVERIFY(finishedSpy.wait());
+
+    QScopedPointer<Database> db(reader.takeDatabase());
+    QVERIFY(db);
+
+    // history items have no parent, they have to be moved to the thread separately
+    int historyItems = 0;
+    Q_FOREACH (Entry* entry, db->rootGroup()->entriesRecursive(true)) {
+        QCOMPARE(entry->thread(), reader.thread());
+        QCOMPARE(entry->attributes()->thread(), reader.thread());
+        if (!entry->group()) {
+            historyItems++;
+        }
+    }
+    QVERIFY(historyItems > 0);
+}
+
 QTEST_GUILESS_MAIN(TestKeePass2Reader)
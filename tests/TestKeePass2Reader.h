@@ -32,6 +32,10 @@ private Q_SLOTS:
     void testBrokenHeaderHash();
     void testFormat200();
     void testFormat300();
+    void testPipelined();
+    void testAsyncRead();
+    void testAsyncReadCanceled();
+    void testAsyncReadHistory();
 };
 
 #endif // KEEPASSX_TESTKEEPASS2READER_H
@@ -18,6 +18,7 @@
 #include "TestKeePass2Writer.h"
 
 #include <QtCore/QBuffer>
+#include <QtCore/QThread>
 #include <QtTest/QTest>
 
 #include "tests.h"
@@ -99,6 +100,96 @@ void TestKeePass2Writer::testNonAsciiPasswords()
     QCOMPARE(m_dbTest->rootGroup()->entries()[0]->password(), m_dbOrg->rootGroup()->entries()[0]->password());
 }
 
+void TestKeePass2Writer::testLargeAttachment()
+{
+    QFETCH(int, compressionAlgo);
+
+    CompositeKey key;
+    key.addKey(PasswordKey("test"));
+
+    QByteArray attachment;
+    attachment.resize(300001);
+    quint32 state = 1;
+    for (int i = 0; i < attachment.size(); i++) {
+        state = state * 1103515245 + 12345;
+        attachment[i] = static_cast<char>(state >> 16);
+    }
+
+    Database db;
+    db.setKey(key);
+    db.setCompressionAlgo(static_cast<Database::CompressionAlgorithm>(compressionAlgo));
+    Entry* entry = new Entry();
+    entry->setUuid(Uuid::random());
+    entry->attachments()->set("large.bin", attachment);
+    entry->setGroup(db.rootGroup());
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+
+    KeePass2Writer writer;
+    writer.writeDatabase(&buffer, &db);
+    QVERIFY(!writer.error());
+    buffer.seek(0);
+    KeePass2Reader reader;
+    QScopedPointer<Database> dbTest(reader.readDatabase(&buffer, key));
+    QVERIFY(!reader.hasError());
+    QVERIFY(dbTest);
+
+    QCOMPARE(dbTest->rootGroup()->entries().size(), 1);
+    QCOMPARE(dbTest->rootGroup()->entries().at(0)->attachments()->value("large.bin"), attachment);
+}
+
+void TestKeePass2Writer::testLargeAttachment_data()
+{
+    QTest::addColumn<int>("compressionAlgo");
+
+    QTest::newRow("CompressionNone") << static_cast<int>(Database::CompressionNone);
+    QTest::newRow("CompressionGZip") << static_cast<int>(Database::CompressionGZip);
+}
+
+void TestKeePass2Writer::testManyAttachments()
+{
+    CompositeKey key;
+    key.addKey(PasswordKey("test"));
+
+    Database db;
+    db.setKey(key);
+    db.setCompressionAlgo(Database::CompressionGZip);
+
+    // more attachments than are compressed at once
+    int count = 2 * qMax(1, QThread::idealThreadCount()) + 3;
+    QList<QByteArray> attachments;
+    for (int i = 0; i < count; i++) {
+        QByteArray attachment = QByteArray::number(i).repeated(1000 + i);
+        attachments.append(attachment);
+
+        Entry* entry = new Entry();
+        entry->setUuid(Uuid::random());
+        entry->attachments()->set("attachment.bin", attachment);
+        entry->attachments()->set("shared.bin", QByteArray("shared attachment"));
+        entry->setGroup(db.rootGroup());
+    }
+
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+
+    KeePass2Writer writer;
+    writer.writeDatabase(&buffer, &db);
+    QVERIFY(!writer.error());
+    buffer.seek(0);
+    KeePass2Reader reader;
+    QScopedPointer<Database> dbTest(reader.readDatabase(&buffer, key));
+    QVERIFY(!reader.hasError());
+    QVERIFY(dbTest);
+
+    QList<Entry*> entries = dbTest->rootGroup()->entries();
+    QCOMPARE(entries.size(), count);
+    for (int i = 0; i < count; i++) {
+        QCOMPARE(entries.at(i)->attachments()->value("attachment.bin"), attachments.at(i));
+        QCOMPARE(entries.at(i)->attachments()->value("shared.bin"), QByteArray("shared attachment"));
+    }
+}
+
 void TestKeePass2Writer::cleanupTestCase()
 {
     delete m_dbOrg;
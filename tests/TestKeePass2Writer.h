@@ -32,6 +32,9 @@ private Q_SLOTS:
     void testProtectedAttributes();
     void testAttachments();
     void testNonAsciiPasswords();
+    void testLargeAttachment();
+    void testLargeAttachment_data();
+    void testManyAttachments();
     void cleanupTestCase();
 
 private:
@@ -17,6 +17,7 @@
 
 #include "TestKeePass2XmlReader.h"
 
+#include <QtCore/QBuffer>
 #include <QtCore/QFile>
 #include <QtTest/QTest>
 
@@ -352,6 +353,49 @@ void TestKeePass2XmlReader::testDeletedObjects()
     QVERIFY(objList.isEmpty());
 }
 
+void TestKeePass2XmlReader::testBinaryWhitespace()
+{
+    QByteArray xmlData(
+        "<?xml version=\"1.0\" encoding=\"utf-8\" standalone=\"yes\"?>\n"
+        "<KeePassFile>\n"
+        "\t<Meta>\n"
+        "\t\t<Binaries>\n"
+        "\t\t\t<Binary ID=\"0\">\n"
+        "\t\t\t\tMDEyMzQ1Njc4OWFi\n"
+        "\t\t\t\tY2RlZmdo<!-- comment -->aWprbG1u\r\n"
+        "\t\t\t\tb3BxcnN0dXZ3eHl6\n"
+        "\t\t\t</Binary>\n"
+        "\t\t</Binaries>\n"
+        "\t</Meta>\n"
+        "\t<Root>\n"
+        "\t\t<Group>\n"
+        "\t\t\t<UUID>lmU+9n0aeESKZvcEze+bRg==</UUID>\n"
+        "\t\t\t<Name>Test</Name>\n"
+        "\t\t\t<Entry>\n"
+        "\t\t\t\t<UUID>AaUYVdXsI02h4T1RiAlgtg==</UUID>\n"
+        "\t\t\t\t<Binary>\n"
+        "\t\t\t\t\t<Key>attach.txt</Key>\n"
+        "\t\t\t\t\t<Value Ref=\"0\" />\n"
+        "\t\t\t\t</Binary>\n"
+        "\t\t\t</Entry>\n"
+        "\t\t</Group>\n"
+        "\t</Root>\n"
+        "</KeePassFile>\n");
+
+    QBuffer buffer(&xmlData);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    KeePass2XmlReader reader;
+    QScopedPointer<Database> db(reader.readDatabase(&buffer));
+    QVERIFY(db);
+    QVERIFY(!reader.hasError());
+
+    QCOMPARE(db->rootGroup()->entries().size(), 1);
+    Entry* entry = db->rootGroup()->entries().at(0);
+    QCOMPARE(entry->attachments()->value("attach.txt"),
+             QByteArray("0123456789abcdefghijklmnopqrstuvwxyz"));
+}
+
 void TestKeePass2XmlReader::testBroken()
 {
     QFETCH(QString, baseName);
@@ -39,6 +39,7 @@ private Q_SLOTS:
     void testEntry2();
     void testEntryHistory();
     void testDeletedObjects();
+    void testBinaryWhitespace();
     void testBroken();
     void testBroken_data();
     void cleanupTestCase();
@@ -24,7 +24,9 @@
 #include "tests.h"
 #include "core/Database.h"
 #include "core/Metadata.h"
+#include "crypto/AesKeyTransform.h"
 #include "crypto/Crypto.h"
+#include "crypto/SymmetricCipher.h"
 #include "format/KeePass2Reader.h"
 #include "format/KeePass2Writer.h"
 #include "keys/CompositeKey.h"
@@ -165,4 +167,88 @@ void TestKeys::testFileKeyError()
     errorMsg = "";
 }
 
+void TestKeys::testAesKeyTransform()
+{
+    const QByteArray seed = QByteArray::fromHex("4b4c4d4e4f505152535455565758595a5b5c5d5e5f606162636465666768696a");
+    const QByteArray key = QByteArray::fromHex("7e7d7c7b7a797877767574737271706f");
+
+    // reference values calculated with openssl
+    QByteArray data = key;
+    AesKeyTransform transform(seed);
+    transform.transform(data, 1);
+    QCOMPARE(data, QByteArray::fromHex("76ffcd3bdd24e41c7ecf790f0358df09"));
+    transform.transform(data, 2);
+    QCOMPARE(data, QByteArray::fromHex("0b25dd4b24da62de117c09dbf8505728"));
+
+    // the kernel must produce the same result as libgcrypt
+    const quint64 rounds = 10007;
+    QByteArray dataCipher = key;
+    SymmetricCipher cipher(SymmetricCipher::Aes256, SymmetricCipher::Ecb,
+                           SymmetricCipher::Encrypt, seed, QByteArray(16, 0));
+    cipher.processInPlace(dataCipher, rounds);
+
+    QByteArray dataTransform = key;
+    AesKeyTransform transform2(seed);
+    transform2.transform(dataTransform, rounds);
+
+    QCOMPARE(dataTransform, dataCipher);
+
+    // both halves of a key at once
+    QByteArray key2 = QByteArray::fromHex("000102030405060708090a0b0c0d0e0f");
+    QByteArray dataSeparate1 = key;
+    QByteArray dataSeparate2 = key2;
+    transform2.transform(dataSeparate1, rounds);
+    transform2.transform(dataSeparate2, rounds);
+
+    QByteArray dataInterleaved = key + key2;
+    transform2.transform(dataInterleaved, rounds);
+
+    QCOMPARE(dataInterleaved, dataSeparate1 + dataSeparate2);
+}
+
+void TestKeys::testDatabaseKeyReuse()
+{
+    PasswordKey password1;
+    password1.setPassword("password1");
+    CompositeKey key1;
+    key1.addKey(password1);
+
+    PasswordKey password2;
+    password2.setPassword("password2");
+    CompositeKey key2;
+    key2.addKey(password2);
+
+    Database db;
+    db.setTransformRounds(1000);
+    db.setKey(key1);
+    QByteArray seed = db.transformSeed();
+    QByteArray transformedKey = db.transformedMasterKey();
+    QCOMPARE(transformedKey, key1.transform(seed, 1000));
+    QVERIFY(db.verifyKey(key1));
+    QVERIFY(!db.verifyKey(key2));
+
+    // same key, nothing to derive
+    db.setKey(key1);
+    QCOMPARE(db.transformSeed(), seed);
+    QCOMPARE(db.transformedMasterKey(), transformedKey);
+
+    db.setKey(key2);
+    QVERIFY(db.transformSeed() != seed);
+    QCOMPARE(db.transformedMasterKey(), key2.transform(db.transformSeed(), 1000));
+    QVERIFY(db.verifyKey(key2));
+
+    // derived in the background
+    seed = db.transformSeed();
+    db.setTransformRounds(2000);
+    QCOMPARE(db.transformRounds(), static_cast<quint64>(2000));
+    QVERIFY(db.transformSeed() != seed);
+    QCOMPARE(db.transformedMasterKey(), key2.transform(db.transformSeed(), 2000));
+
+    // supersedes a pending transformation
+    db.setTransformRounds(3000);
+    db.setKey(key1);
+    QCOMPARE(db.transformedMasterKey(), key1.transform(db.transformSeed(), 3000));
+    QVERIFY(db.verifyKey(key1));
+}
+
 QTEST_GUILESS_MAIN(TestKeys)
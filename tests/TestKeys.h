@@ -31,6 +31,8 @@ private Q_SLOTS:
     void testFileKey_data();
     void testCreateFileKey();
     void testFileKeyError();
+    void testAesKeyTransform();
+    void testDatabaseKeyReuse();
 };
 
 #endif // KEEPASSX_TESTKEYS_H
@@ -0,0 +1,105 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestPasswordGenerator.h"
+
+#include <QtTest/QTest>
+
+#include "tests.h"
+#include "core/PasswordGenerator.h"
+#include "crypto/Crypto.h"
+
+void TestPasswordGenerator::initTestCase()
+{
+    Crypto::init();
+}
+
+void TestPasswordGenerator::testGeneratePasswords()
+{
+    PasswordGenerator::Profile profile = passwordGenerator()->compileProfile(
+                16, PasswordGenerator::LowerLetters | PasswordGenerator::Numbers, 0);
+    QCOMPARE(profile.chars.size(), 26 + 10);
+
+    QStringList passwords = passwordGenerator()->generatePasswords(profile, 1000);
+    QCOMPARE(passwords.size(), 1000);
+    QCOMPARE(passwords.toSet().size(), 1000);
+
+    QVector<int> counts(128, 0);
+    Q_FOREACH (const QString& password, passwords) {
+        QCOMPARE(password.size(), 16);
+
+        Q_FOREACH (QChar ch, password) {
+            QVERIFY(profile.chars.contains(ch));
+            counts[ch.unicode()]++;
+        }
+    }
+
+    // every char is used 1000 * 16 / 36 = 444 times on average
+    Q_FOREACH (QChar ch, profile.chars) {
+        QVERIFY(counts[ch.unicode()] > 300);
+        QVERIFY(counts[ch.unicode()] < 600);
+    }
+
+    QVERIFY(passwordGenerator()->generatePasswords(profile, 0).isEmpty());
+}
+
+void TestPasswordGenerator::testCharFromEveryGroup()
+{
+    PasswordGenerator::CharClasses classes = PasswordGenerator::LowerLetters | PasswordGenerator::UpperLetters
+            | PasswordGenerator::Numbers | PasswordGenerator::SpecialCharacters;
+    PasswordGenerator::Profile profile = passwordGenerator()->compileProfile(
+                4, classes, PasswordGenerator::CharFromEveryGroup);
+    QCOMPARE(profile.groups.size(), 4);
+
+    Q_FOREACH (const QString& password, passwordGenerator()->generatePasswords(profile, 200)) {
+        QCOMPARE(password.size(), 4);
+
+        Q_FOREACH (const PasswordGroup& group, profile.groups) {
+            bool found = false;
+            Q_FOREACH (QChar ch, password) {
+                found = found || group.contains(ch);
+            }
+            QVERIFY(found);
+        }
+    }
+}
+
+void TestPasswordGenerator::testExcludeLookAlike()
+{
+    QString password = passwordGenerator()->generatePassword(
+                1000, PasswordGenerator::UpperLetters | PasswordGenerator::Numbers,
+                PasswordGenerator::ExcludeLookAlike);
+
+    QCOMPARE(password.size(), 1000);
+    QVERIFY(!password.contains('I'));
+    QVERIFY(!password.contains('O'));
+    QVERIFY(!password.contains('0'));
+    QVERIFY(!password.contains('1'));
+}
+
+void TestPasswordGenerator::benchmarkGeneratePasswords()
+{
+    PasswordGenerator::Profile profile = passwordGenerator()->compileProfile(
+                20, PasswordGenerator::LowerLetters | PasswordGenerator::UpperLetters | PasswordGenerator::Numbers,
+                PasswordGenerator::CharFromEveryGroup);
+
+    QBENCHMARK {
+        passwordGenerator()->generatePasswords(profile, 1000);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestPasswordGenerator)
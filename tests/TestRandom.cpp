@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestRandom.h"
+
+#include <QtTest/QTest>
+
+#include "tests.h"
+#include "crypto/Crypto.h"
+#include "crypto/Random.h"
+
+void TestRandom::initTestCase()
+{
+    Crypto::init();
+}
+
+void TestRandom::testArray()
+{
+    QByteArray zeros(32, '\0');
+    QByteArray previous;
+
+    // crosses the boundaries of the internal pool a few times
+    for (int i = 0; i < 1000; i++) {
+        QByteArray data = Random::randomArray(32);
+        QCOMPARE(data.size(), 32);
+        QVERIFY(data != zeros);
+        QVERIFY(data != previous);
+        previous = data;
+    }
+
+    QByteArray large = Random::randomArray(100000);
+    QCOMPARE(large.size(), 100000);
+    QVERIFY(large.left(32) != zeros);
+    QVERIFY(large.right(32) != zeros);
+}
+
+void TestRandom::testUInts()
+{
+    QVector<quint32> values = Random::randomUInts(10000, 10);
+    QCOMPARE(values.size(), 10000);
+
+    QVector<int> counts(10, 0);
+    Q_FOREACH (quint32 value, values) {
+        QVERIFY(value < 10);
+        counts[value]++;
+    }
+
+    Q_FOREACH (int count, counts) {
+        QVERIFY(count > 0);
+    }
+
+    QVERIFY(Random::randomUInts(0, 10).isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestRandom)
@@ -22,7 +22,9 @@
 
 #include "tests.h"
 #include "crypto/Crypto.h"
+#include "crypto/Random.h"
 #include "crypto/SymmetricCipher.h"
+#include "crypto/SymmetricCipherSalsa20.h"
 #include "streams/SymmetricCipherStream.h"
 
 void TestSymmetricCipher::initTestCase()
@@ -168,6 +170,81 @@ void TestSymmetricCipher::testSalsa20()
     QCOMPARE(cipherTextB.mid(448, 64), expectedCipherText4);
 }
 
+void TestSymmetricCipher::testSalsa20Simd()
+{
+    if (!SymmetricCipherSalsa20::hasSse2()) {
+        QSKIP("The CPU doesn't support SSE2.");
+    }
+
+    QByteArray key = Random::randomArray(32);
+    QByteArray iv = Random::randomArray(8);
+
+    SymmetricCipherSalsa20 reference(SymmetricCipher::Salsa20, SymmetricCipher::Stream,
+                                     SymmetricCipher::Encrypt);
+    reference.setSimdEnabled(false);
+    reference.setKey(key);
+    reference.setIv(iv);
+
+    SymmetricCipherSalsa20 simd(SymmetricCipher::Salsa20, SymmetricCipher::Stream,
+                                SymmetricCipher::Encrypt);
+    simd.setKey(key);
+    simd.setIv(iv);
+
+    // chunks that are not a multiple of the four blocks processed at once by the kernel
+    QList<int> chunkSizes;
+    chunkSizes << 64 << 256 << 320 << 4096 << 64 * 1023 << 1024 * 1024 << 48;
+
+    Q_FOREACH (int chunkSize, chunkSizes) {
+        QByteArray data = Random::randomArray(chunkSize);
+        QByteArray inPlace = data;
+
+        QByteArray expected = reference.process(data);
+        simd.processInPlace(inPlace);
+        QCOMPARE(inPlace, expected);
+        QCOMPARE(simd.process(data), reference.process(data));
+    }
+
+    reference.reset();
+    simd.reset();
+    QByteArray zeros(64 * 1024, '\0');
+    QCOMPARE(simd.process(zeros), reference.process(zeros));
+}
+
+void TestSymmetricCipher::testSalsa20SimdCounterCarry()
+{
+    if (!SymmetricCipherSalsa20::hasSse2()) {
+        QSKIP("The CPU doesn't support SSE2.");
+    }
+
+    QByteArray key = Random::randomArray(32);
+    QByteArray iv = Random::randomArray(8);
+
+    SymmetricCipherSalsa20 reference(SymmetricCipher::Salsa20, SymmetricCipher::Stream,
+                                     SymmetricCipher::Encrypt);
+    reference.setSimdEnabled(false);
+    reference.setKey(key);
+    reference.setIv(iv);
+
+    SymmetricCipherSalsa20 simd(SymmetricCipher::Salsa20, SymmetricCipher::Stream,
+                                SymmetricCipher::Encrypt);
+    simd.setKey(key);
+    simd.setIv(iv);
+
+    // the low counter word overflows within the first four blocks processed by the kernel
+    QList<quint64> counters;
+    counters << Q_UINT64_C(0xFFFFFFFE) << Q_UINT64_C(0xFFFFFFFC) << Q_UINT64_C(0x1FFFFFFFF);
+
+    Q_FOREACH (quint64 counter, counters) {
+        reference.setBlockCounter(counter);
+        simd.setBlockCounter(counter);
+
+        QByteArray data = Random::randomArray(64 * 10);
+        QCOMPARE(simd.process(data), reference.process(data));
+        // both continue with the same counter
+        QCOMPARE(simd.process(data), reference.process(data));
+    }
+}
+
 void TestSymmetricCipher::testPadding()
 {
     QByteArray key = QByteArray::fromHex("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4");
@@ -193,4 +270,47 @@ void TestSymmetricCipher::testPadding()
     QCOMPARE(decrypted, plainText);
 }
 
+void TestSymmetricCipher::testStreamLargeData()
+{
+    QByteArray key = QByteArray::fromHex("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4");
+    QByteArray iv = QByteArray::fromHex("000102030405060708090a0b0c0d0e0f");
+
+    // spans several internal chunks and doesn't end on a block boundary
+    QByteArray plainText;
+    for (int i = 0; i < 200003; i++) {
+        plainText.append(static_cast<char>(i % 251));
+    }
+
+    QByteArray plainTextPadded = plainText;
+    plainTextPadded.append(QByteArray(13, 13));
+    SymmetricCipher cipher(SymmetricCipher::Aes256, SymmetricCipher::Cbc, SymmetricCipher::Encrypt, key, iv);
+    QByteArray cipherText = cipher.process(plainTextPadded);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::ReadWrite);
+
+    SymmetricCipherStream streamEnc(&buffer, SymmetricCipher::Aes256, SymmetricCipher::Cbc,
+                                    SymmetricCipher::Encrypt, key, iv);
+    streamEnc.open(QIODevice::WriteOnly);
+    int pos = 0;
+    int writeSize = 1;
+    while (pos < plainText.size()) {
+        int len = qMin(writeSize, plainText.size() - pos);
+        QCOMPARE(streamEnc.write(plainText.constData() + pos, len), static_cast<qint64>(len));
+        pos += len;
+        writeSize = (writeSize * 7 + 5) % 100000;
+    }
+    streamEnc.close();
+    QCOMPARE(buffer.data(), cipherText);
+
+    buffer.reset();
+    SymmetricCipherStream streamDec(&buffer, SymmetricCipher::Aes256, SymmetricCipher::Cbc,
+                                    SymmetricCipher::Decrypt, key, iv);
+    streamDec.open(QIODevice::ReadOnly);
+    QByteArray decrypted = streamDec.read(7);
+    decrypted.append(streamDec.read(70000));
+    decrypted.append(streamDec.readAll());
+    QCOMPARE(decrypted, plainText);
+}
+
 QTEST_GUILESS_MAIN(TestSymmetricCipher)
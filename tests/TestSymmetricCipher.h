@@ -29,7 +29,10 @@ private Q_SLOTS:
     void testAes256CbcEncryption();
     void testAes256CbcDecryption();
     void testSalsa20();
+    void testSalsa20Simd();
+    void testSalsa20SimdCounterCarry();
     void testPadding();
+    void testStreamLargeData();
 };
 
 #endif // KEEPASSX_TESTSYMMETRICCIPHER_H
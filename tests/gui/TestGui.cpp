@@ -69,6 +69,9 @@ void TestGui::testOpenDatabase()
 
     QTest::keyClicks(editPassword, "a");
     QTest::keyClick(editPassword, Qt::Key_Enter);
+
+    // the database is read in the background
+    QTRY_VERIFY(!databaseOpenWidget->isVisible());
 }
 
 void TestGui::testTabs()
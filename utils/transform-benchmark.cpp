@@ -0,0 +1,407 @@
+/*
+ *  Copyright (C) 2014 Felix Geyer <debfx@fobos.de>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QStringList>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
+
+#include "crypto/AesKeyTransform.h"
+#include "crypto/Crypto.h"
+
+/**
+ * Measures the key transformation throughput of one backend.
+ *
+ * Each configuration (backend, number of concurrent threads, rounds per
+ * AesKeyTransform::transform() call, one or two interleaved blocks) is
+ * sampled several times. The results are reported as rounds per second and
+ * thread, which is what determines the unlock latency since both halves of
+ * the key are transformed at the same time.
+ */
+
+namespace {
+
+struct Options
+{
+    Options()
+        : msec(1000)
+        , samples(5)
+        , targetMsec(1000)
+        , json(false)
+    {
+    }
+
+    int msec;
+    int samples;
+    int targetMsec;
+    bool json;
+    QList<AesKeyTransform::Backend> backends;
+    QList<int> threadCounts;
+    QList<int> chunkSizes;
+    QList<int> blockCounts;
+};
+
+struct Result
+{
+    AesKeyTransform::Backend backend;
+    int threads;
+    int chunkSize;
+    int blocks;
+    double mean;
+    double stddev;
+    double min;
+    double max;
+};
+
+class BenchmarkThread : public QThread
+{
+public:
+    BenchmarkThread(AesKeyTransform::Backend backend, int msec, int chunkSize, int blocks)
+        : m_backend(backend)
+        , m_msec(msec)
+        , m_chunkSize(chunkSize)
+        , m_blocks(blocks)
+        , m_roundsPerSecond(0)
+    {
+    }
+
+    double roundsPerSecond() const
+    {
+        return m_roundsPerSecond;
+    }
+
+protected:
+    void run()
+    {
+        QByteArray key = QByteArray(m_blocks * 16, '\x7E');
+        QByteArray seed = QByteArray(32, '\x4B');
+
+        AesKeyTransform transform(seed, m_backend);
+
+        const qint64 limit = static_cast<qint64>(m_msec) * 1000000;
+        quint64 rounds = 0;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        do {
+            transform.transform(key, m_chunkSize);
+            rounds += m_chunkSize;
+        } while (timer.nsecsElapsed() < limit);
+
+        m_roundsPerSecond = static_cast<double>(rounds) * 1e9 / static_cast<double>(timer.nsecsElapsed());
+    }
+
+private:
+    const AesKeyTransform::Backend m_backend;
+    const int m_msec;
+    const int m_chunkSize;
+    const int m_blocks;
+    double m_roundsPerSecond;
+};
+
+QString backendName(AesKeyTransform::Backend backend)
+{
+    switch (backend) {
+    case AesKeyTransform::BackendGcrypt:
+        return "gcrypt";
+    case AesKeyTransform::BackendAesNi:
+        return "aesni";
+    default:
+        return "auto";
+    }
+}
+
+/**
+ * Runs threads concurrently and returns the mean rate per thread.
+ */
+double sample(AesKeyTransform::Backend backend, int threads, int chunkSize, int blocks, int msec)
+{
+    QList<BenchmarkThread*> benchmarkThreads;
+    for (int i = 0; i < threads; i++) {
+        benchmarkThreads.append(new BenchmarkThread(backend, msec, chunkSize, blocks));
+    }
+
+    Q_FOREACH (BenchmarkThread* thread, benchmarkThreads) {
+        thread->start();
+    }
+
+    double sum = 0;
+    Q_FOREACH (BenchmarkThread* thread, benchmarkThreads) {
+        thread->wait();
+        sum += thread->roundsPerSecond();
+    }
+
+    qDeleteAll(benchmarkThreads);
+
+    return sum / threads;
+}
+
+Result benchmark(AesKeyTransform::Backend backend, int threads, int chunkSize, int blocks,
+                 const Options& options)
+{
+    // warm up caches and let the cpu leave its power saving states
+    sample(backend, threads, chunkSize, blocks, qMin(options.msec, 100));
+
+    QList<double> samples;
+    for (int i = 0; i < options.samples; i++) {
+        samples.append(sample(backend, threads, chunkSize, blocks, options.msec));
+    }
+
+    Result result;
+    result.backend = backend;
+    result.threads = threads;
+    result.chunkSize = chunkSize;
+    result.blocks = blocks;
+    result.min = samples.first();
+    result.max = samples.first();
+
+    double sum = 0;
+    Q_FOREACH (double value, samples) {
+        sum += value;
+        result.min = qMin(result.min, value);
+        result.max = qMax(result.max, value);
+    }
+    result.mean = sum / samples.size();
+
+    double squaredDiffs = 0;
+    Q_FOREACH (double value, samples) {
+        squaredDiffs += (value - result.mean) * (value - result.mean);
+    }
+    result.stddev = samples.size() > 1 ? sqrt(squaredDiffs / (samples.size() - 1)) : 0;
+
+    return result;
+}
+
+quint64 roundsForTarget(const Result& result, int targetMsec)
+{
+    return static_cast<quint64>(result.mean * targetMsec / 1000);
+}
+
+bool parseIntList(const QString& value, QList<int>& list)
+{
+    list.clear();
+
+    Q_FOREACH (const QString& item, value.split(',', QString::SkipEmptyParts)) {
+        bool ok;
+        int number = item.toInt(&ok);
+        if (!ok || number <= 0) {
+            return false;
+        }
+        list.append(number);
+    }
+
+    return !list.isEmpty();
+}
+
+bool parseBackends(const QString& value, QList<AesKeyTransform::Backend>& list)
+{
+    list.clear();
+
+    Q_FOREACH (const QString& item, value.split(',', QString::SkipEmptyParts)) {
+        if (item == "gcrypt") {
+            list.append(AesKeyTransform::BackendGcrypt);
+        }
+        else if (item == "aesni") {
+            list.append(AesKeyTransform::BackendAesNi);
+        }
+        else {
+            return false;
+        }
+    }
+
+    return !list.isEmpty();
+}
+
+bool parseArguments(const QStringList& args, Options& options)
+{
+    for (int i = 1; i < args.size(); i++) {
+        const QString& arg = args[i];
+
+        if (arg == "--json") {
+            options.json = true;
+            continue;
+        }
+
+        if (i + 1 >= args.size()) {
+            qCritical("No value given for option \"%s\"", qPrintable(arg));
+            return false;
+        }
+        const QString& value = args[++i];
+
+        bool ok = true;
+        if (arg == "--msec") {
+            options.msec = value.toInt(&ok);
+            ok = ok && options.msec > 0;
+        }
+        else if (arg == "--samples") {
+            options.samples = value.toInt(&ok);
+            ok = ok && options.samples > 0;
+        }
+        else if (arg == "--target-msec") {
+            options.targetMsec = value.toInt(&ok);
+            ok = ok && options.targetMsec > 0;
+        }
+        else if (arg == "--threads") {
+            ok = parseIntList(value, options.threadCounts);
+        }
+        else if (arg == "--chunk") {
+            ok = parseIntList(value, options.chunkSizes);
+        }
+        else if (arg == "--blocks") {
+            ok = parseIntList(value, options.blockCounts);
+            Q_FOREACH (int blocks, options.blockCounts) {
+                ok = ok && blocks <= 2;
+            }
+        }
+        else if (arg == "--backend") {
+            ok = parseBackends(value, options.backends);
+        }
+        else {
+            qCritical("Unknown option \"%s\"", qPrintable(arg));
+            return false;
+        }
+
+        if (!ok) {
+            qCritical("Invalid value \"%s\" for option \"%s\"", qPrintable(value), qPrintable(arg));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void printText(const QList<Result>& results, const Options& options)
+{
+    QTextStream out(stdout);
+
+    out << "# rounds per second and thread over " << options.samples << " samples of "
+        << options.msec << " ms\n";
+    out << "# target_rounds: TransformRounds value for a " << options.targetMsec
+        << " ms key transformation\n";
+    out << "# blocks: 16 byte blocks transformed per thread, 2 interleaves both key halves\n";
+    out << "backend\tthreads\tchunk\tblocks\tmean\tstddev\tcv%\tmin\tmax\ttarget_rounds\n";
+
+    Q_FOREACH (const Result& result, results) {
+        out << backendName(result.backend) << "\t"
+            << result.threads << "\t"
+            << result.chunkSize << "\t"
+            << result.blocks << "\t"
+            << qRound64(result.mean) << "\t"
+            << qRound64(result.stddev) << "\t"
+            << QString::number(100 * result.stddev / result.mean, 'f', 2) << "\t"
+            << qRound64(result.min) << "\t"
+            << qRound64(result.max) << "\t"
+            << roundsForTarget(result, options.targetMsec) << "\n";
+    }
+}
+
+void printJson(const QList<Result>& results, const Options& options)
+{
+    QJsonArray resultArray;
+    Q_FOREACH (const Result& result, results) {
+        QJsonObject object;
+        object.insert("backend", backendName(result.backend));
+        object.insert("threads", result.threads);
+        object.insert("chunk", result.chunkSize);
+        object.insert("blocks", result.blocks);
+        object.insert("mean", result.mean);
+        object.insert("stddev", result.stddev);
+        object.insert("min", result.min);
+        object.insert("max", result.max);
+        object.insert("target_rounds", static_cast<double>(roundsForTarget(result, options.targetMsec)));
+        resultArray.append(object);
+    }
+
+    QJsonObject root;
+    root.insert("ideal_thread_count", QThread::idealThreadCount());
+    root.insert("aesni_available", AesKeyTransform::hasAesNi());
+    root.insert("msec", options.msec);
+    root.insert("samples", options.samples);
+    root.insert("target_msec", options.targetMsec);
+    root.insert("results", resultArray);
+
+    QTextStream out(stdout);
+    out << QJsonDocument(root).toJson();
+}
+
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    Options options;
+    if (!parseArguments(app.arguments(), options)) {
+        qCritical("Usage: transform-benchmark [--msec <n>] [--samples <n>] [--target-msec <n>]\n"
+                  "                           [--threads <n,...>] [--chunk <n,...>] [--blocks <1|2,...>]\n"
+                  "                           [--backend <gcrypt|aesni,...>] [--json]");
+        return 1;
+    }
+
+    Crypto::init();
+
+    if (options.backends.isEmpty()) {
+        options.backends.append(AesKeyTransform::BackendGcrypt);
+        if (AesKeyTransform::hasAesNi()) {
+            options.backends.append(AesKeyTransform::BackendAesNi);
+        }
+    }
+    if (options.threadCounts.isEmpty()) {
+        options.threadCounts << 1 << 2;
+    }
+    if (options.chunkSizes.isEmpty()) {
+        options.chunkSizes << 100 << 10000;
+    }
+    if (options.blockCounts.isEmpty()) {
+        options.blockCounts << 1 << 2;
+    }
+
+    Q_FOREACH (AesKeyTransform::Backend backend, options.backends) {
+        if (!AesKeyTransform::isBackendAvailable(backend)) {
+            qCritical("Backend \"%s\" is not available.", qPrintable(backendName(backend)));
+            return 1;
+        }
+    }
+
+    QList<Result> results;
+    Q_FOREACH (AesKeyTransform::Backend backend, options.backends) {
+        Q_FOREACH (int threads, options.threadCounts) {
+            Q_FOREACH (int chunkSize, options.chunkSizes) {
+                Q_FOREACH (int blocks, options.blockCounts) {
+                    results.append(benchmark(backend, threads, chunkSize, blocks, options));
+                }
+            }
+        }
+    }
+
+    if (options.json) {
+        printJson(results, options);
+    }
+    else {
+        printText(results, options);
+    }
+
+    return 0;
+}